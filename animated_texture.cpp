@@ -0,0 +1,49 @@
+#include "animated_texture.h"
+
+// A frame late by more than this (a stall, a hidden window) restarts the clock instead of catching up
+constexpr float maxLateSeconds{0.25f};
+
+AnimatedTexture::~AnimatedTexture()
+{
+    if (current.id != 0)
+    {
+        UnloadTexture(current);
+    }
+}
+
+bool AnimatedTexture::open(const char *path)
+{
+    if (!stream.open(path))
+    {
+        TraceLog(LOG_WARNING, "GIF: Failed to open %s", path);
+        return false;
+    }
+    // Allocated once at the canvas size, every frame after is an update in place
+    Image blank = GenImageColor(stream.width(), stream.height(), BLANK);
+    current = LoadTextureFromImage(blank);
+    UnloadImage(blank);
+    return current.id != 0;
+}
+
+void AnimatedTexture::update(float deltaTime)
+{
+    if (current.id == 0)
+    {
+        return;
+    }
+    elapsed += deltaTime;
+    if (shown && elapsed < delay)
+    {
+        return;
+    }
+    const GifFrame *frame = stream.front();
+    if (frame == nullptr)
+    {
+        return;
+    }
+    UpdateTexture(current, frame->rgba.data());
+    elapsed = shown && elapsed - delay < maxLateSeconds ? elapsed - delay : 0.f;
+    delay = static_cast<float>(frame->delayMs) / 1000.f;
+    shown = true;
+    stream.pop();
+}
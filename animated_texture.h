@@ -0,0 +1,41 @@
+/**
+ * An animated GIF on a single texture. Frames stream in from a GifStream
+ * decoding ahead on its own thread, and update() copies the next one into
+ * the same texture when the current one's delay is up. Needs a GL context,
+ * so it lives in the raylib front end only.
+*/
+
+#ifndef GGJ24_ANIMATED_TEXTURE_H
+#define GGJ24_ANIMATED_TEXTURE_H
+
+#include "gif_stream.h"
+#include "raylib.h"
+
+class AnimatedTexture
+{
+public:
+    AnimatedTexture() = default;
+    AnimatedTexture(const AnimatedTexture &) = delete;
+    AnimatedTexture &operator=(const AnimatedTexture &) = delete;
+    ~AnimatedTexture();
+
+    // Starts streaming path, false if it is not a GIF. The texture is blank until the first update()
+    bool open(const char *path);
+
+    // GL thread: advances the animation by deltaTime and uploads the frame it
+    // lands on. Holds the current frame if the decoder is behind
+    void update(float deltaTime);
+
+    // Empty texture (id 0) until open() succeeds
+    const Texture2D &texture() const { return current; }
+
+private:
+    GifStream stream;
+    Texture2D current{};
+    // Time into the frame on screen, and how long it stays there
+    float elapsed{0.f};
+    float delay{0.f};
+    bool shown{false};
+};
+
+#endif //GGJ24_ANIMATED_TEXTURE_H
@@ -0,0 +1,203 @@
+#include "arena_bvh.h"
+
+#include "raymath.h"
+#include "swept_collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+constexpr int maxLeafSize{2};
+constexpr int maxStackDepth{64};
+
+static Vector3 boxCentre(const BoundingBox &box)
+{
+    return Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+}
+
+static BoundingBox mergeBoxes(const BoundingBox &a, const BoundingBox &b)
+{
+    return {Vector3Min(a.min, b.min), Vector3Max(a.max, b.max)};
+}
+
+static bool boxesOverlap(const BoundingBox &a, const BoundingBox &b)
+{
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+static float axisOf(Vector3 v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+void ArenaBvh::build(const std::vector<BoundingBox> &boxes)
+{
+    nodes.clear();
+    primitives = boxes;
+    primitiveIndex.resize(boxes.size());
+    std::iota(primitiveIndex.begin(), primitiveIndex.end(), 0);
+    if (boxes.empty())
+    {
+        return;
+    }
+
+    nodes.reserve(2 * boxes.size());
+    nodes.push_back({});
+    buildNode(0, 0, static_cast<int>(boxes.size()));
+}
+
+void ArenaBvh::buildNode(int node, int first, int count)
+{
+    BoundingBox bounds = primitives[first];
+    BoundingBox centres = {boxCentre(bounds), boxCentre(bounds)};
+    for (int i = first + 1; i < first + count; i++)
+    {
+        bounds = mergeBoxes(bounds, primitives[i]);
+        Vector3 centre = boxCentre(primitives[i]);
+        centres = {Vector3Min(centres.min, centre), Vector3Max(centres.max, centre)};
+    }
+    nodes[node].bounds = bounds;
+
+    if (count <= maxLeafSize)
+    {
+        nodes[node].first = first;
+        nodes[node].count = count;
+        return;
+    }
+
+    // Median split on the widest axis of the centres
+    Vector3 extent = Vector3Subtract(centres.max, centres.min);
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    int half = count / 2;
+
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::nth_element(order.begin(), order.begin() + half, order.end(), [&](int a, int b)
+    {
+        return axisOf(boxCentre(primitives[first + a]), axis) < axisOf(boxCentre(primitives[first + b]), axis);
+    });
+    std::vector<BoundingBox> boxes(count);
+    std::vector<int> indices(count);
+    for (int i = 0; i < count; i++)
+    {
+        boxes[i] = primitives[first + order[i]];
+        indices[i] = primitiveIndex[first + order[i]];
+    }
+    std::copy(boxes.begin(), boxes.end(), primitives.begin() + first);
+    std::copy(indices.begin(), indices.end(), primitiveIndex.begin() + first);
+
+    int left = static_cast<int>(nodes.size());
+    nodes.push_back({});
+    nodes.push_back({});
+    nodes[node].first = left;
+    nodes[node].count = 0;
+    buildNode(left, first, half);
+    buildNode(left + 1, first + half, count - half);
+}
+
+bool ArenaBvh::segmentHits(Vector3 from, Vector3 invDir, float maxT, float *t, int *box) const
+{
+    if (nodes.empty())
+    {
+        return false;
+    }
+
+    int stack[maxStackDepth];
+    int depth = 0;
+    stack[depth++] = 0;
+    bool hit = false;
+    float entry;
+
+    while (depth > 0)
+    {
+        const Node &node = nodes[stack[--depth]];
+        if (!sweptAabb(node.bounds, from, invDir, maxT, &entry))
+        {
+            continue;
+        }
+
+        if (node.count == 0)
+        {
+            stack[depth++] = node.first;
+            stack[depth++] = node.first + 1;
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++)
+        {
+            if (sweptAabb(primitives[i], from, invDir, maxT, &entry))
+            {
+                hit = true;
+                // Shrinking maxT culls everything behind the closest hit so far
+                maxT = entry;
+                *t = entry;
+                *box = primitiveIndex[i];
+            }
+        }
+    }
+    return hit;
+}
+
+bool ArenaBvh::intersectSegment(Vector3 from, Vector3 to, float *t, int *box) const
+{
+    return segmentHits(from, inverseDirection(Vector3Subtract(to, from)), 1.f, t, box);
+}
+
+int ArenaBvh::intersectSegments(int count, const Vector3 *from, const Vector3 *to, int *hitIndices, float *hitT) const
+{
+    int hits = 0;
+    float t;
+    int box;
+    for (int i = 0; i < count; i++)
+    {
+        if (segmentHits(from[i], inverseDirection(Vector3Subtract(to[i], from[i])), 1.f, &t, &box))
+        {
+            hitIndices[hits] = i;
+            hitT[hits] = t;
+            hits++;
+        }
+    }
+    return hits;
+}
+
+int ArenaBvh::overlapBoxes(int count, const BoundingBox *boxes, int *hitIndices) const
+{
+    if (nodes.empty())
+    {
+        return 0;
+    }
+
+    int hits = 0;
+    int stack[maxStackDepth];
+    for (int i = 0; i < count; i++)
+    {
+        int depth = 0;
+        stack[depth++] = 0;
+        bool hit = false;
+        while (depth > 0 && !hit)
+        {
+            const Node &node = nodes[stack[--depth]];
+            if (!boxesOverlap(node.bounds, boxes[i]))
+            {
+                continue;
+            }
+            if (node.count == 0)
+            {
+                stack[depth++] = node.first;
+                stack[depth++] = node.first + 1;
+                continue;
+            }
+            for (int p = node.first; p < node.first + node.count && !hit; p++)
+            {
+                hit = boxesOverlap(primitives[p], boxes[i]);
+            }
+        }
+        if (hit)
+        {
+            hitIndices[hits++] = i;
+        }
+    }
+    return hits;
+}
@@ -0,0 +1,48 @@
+/**
+ * Static AABB bounding volume hierarchy over the arena's level geometry
+ * (columns and walls). Built once when the arena is generated, then queried
+ * with segments (projectile moves, rays) and boxes. Queries walk the tree,
+ * so their cost grows with log(box count) rather than the column count.
+*/
+
+#ifndef GGJ24_ARENA_BVH_H
+#define GGJ24_ARENA_BVH_H
+
+#include "raylib.h"
+
+#include <vector>
+
+class ArenaBvh
+{
+public:
+    void build(const std::vector<BoundingBox> &boxes);
+
+    // Nearest hit along from -> to. On a hit, t is the fraction of the segment
+    // (0..1) and box the index passed to build()
+    bool intersectSegment(Vector3 from, Vector3 to, float *t, int *box) const;
+    // Batched intersectSegment() for count segments, writes the index and t of
+    // every segment that touches geometry and returns how many
+    int intersectSegments(int count, const Vector3 *from, const Vector3 *to, int *hitIndices, float *hitT) const;
+    // Box overlap, same batching as intersectSegments
+    int overlapBoxes(int count, const BoundingBox *boxes, int *hitIndices) const;
+
+    int boxCount() const { return static_cast<int>(primitives.size()); }
+    int nodeCount() const { return static_cast<int>(nodes.size()); }
+
+private:
+    struct Node
+    {
+        BoundingBox bounds;
+        int first;  // first primitive for leaves, left child for inner nodes (right is left + 1)
+        int count;  // primitives in a leaf, 0 for inner nodes
+    };
+
+    void buildNode(int node, int first, int count);
+    bool segmentHits(Vector3 from, Vector3 invDir, float maxT, float *t, int *box) const;
+
+    std::vector<Node> nodes;
+    std::vector<BoundingBox> primitives;    // boxes reordered to match the leaves
+    std::vector<int> primitiveIndex;        // original index of each reordered box
+};
+
+#endif //GGJ24_ARENA_BVH_H
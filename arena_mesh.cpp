@@ -0,0 +1,79 @@
+#include "arena_mesh.h"
+
+#include "sim_snapshot.h"
+
+static void pushVertex(std::vector<float> &vertices, std::vector<unsigned char> &colors, Vector3 v, Color color)
+{
+    vertices.insert(vertices.end(), {v.x, v.y, v.z});
+    colors.insert(colors.end(), {color.r, color.g, color.b, color.a});
+}
+
+bool ArenaMesh::bake(const SimSnapshot &sim)
+{
+    if (sim.arenaRevision == bakedRevision)
+    {
+        return false;
+    }
+
+    triangles.clear();
+    triangleRgba.clear();
+    lines.clear();
+    lineRgba.clear();
+
+    // Same layout the scene used to draw cube by cube
+    float half = Sim::arenaSize / 2.f;
+    addQuad({-half, 0.f, half}, {half, 0.f, half}, {half, 0.f, -half}, {-half, 0.f, -half}, DARKBROWN);  // ground plane
+    addBox({-half, 2.5f, 0.f}, {1.f, 5.f, Sim::arenaSize}, BLUE);                                        // BLUE WALL
+    addBox({half, 2.5f, 0.f}, {1.f, 5.f, Sim::arenaSize}, LIME);                                         // LIME WALL
+    addBox({0.f, 2.5f, half}, {Sim::arenaSize, 5.f, 1.f}, GOLD);                                         // GOLD WALL
+    addBox({0.f, 2.5f, -half}, {Sim::arenaSize, 5.f, 1.f}, DARKGRAY);                                    // DarkGray WALL
+
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        addBox(sim.positions[i], {2.f, sim.heights[i], 2.f}, sim.colors[i]);
+        addBoxWires(sim.positions[i], {2.f, sim.heights[i], 2.f}, MAROON);
+    }
+
+    bakedRevision = sim.arenaRevision;
+    return true;
+}
+
+void ArenaMesh::addQuad(Vector3 a, Vector3 b, Vector3 c, Vector3 d, Color color)
+{
+    // Counter-clockwise seen from the front, like raylib's own shapes, so back face culling keeps it
+    for (Vector3 v : {a, b, c, a, c, d})
+    {
+        pushVertex(triangles, triangleRgba, v, color);
+    }
+}
+
+void ArenaMesh::addBox(Vector3 centre, Vector3 size, Color color)
+{
+    float x0 = centre.x - size.x / 2.f, x1 = centre.x + size.x / 2.f;
+    float y0 = centre.y - size.y / 2.f, y1 = centre.y + size.y / 2.f;
+    float z0 = centre.z - size.z / 2.f, z1 = centre.z + size.z / 2.f;
+    addQuad({x0, y0, z1}, {x1, y0, z1}, {x1, y1, z1}, {x0, y1, z1}, color);    // front (+z)
+    addQuad({x1, y0, z0}, {x0, y0, z0}, {x0, y1, z0}, {x1, y1, z0}, color);    // back (-z)
+    addQuad({x1, y0, z1}, {x1, y0, z0}, {x1, y1, z0}, {x1, y1, z1}, color);    // right (+x)
+    addQuad({x0, y0, z0}, {x0, y0, z1}, {x0, y1, z1}, {x0, y1, z0}, color);    // left (-x)
+    addQuad({x0, y1, z1}, {x1, y1, z1}, {x1, y1, z0}, {x0, y1, z0}, color);    // top (+y)
+    addQuad({x0, y0, z0}, {x1, y0, z0}, {x1, y0, z1}, {x0, y0, z1}, color);    // bottom (-y)
+}
+
+void ArenaMesh::addBoxWires(Vector3 centre, Vector3 size, Color color)
+{
+    float x0 = centre.x - size.x / 2.f, x1 = centre.x + size.x / 2.f;
+    float y0 = centre.y - size.y / 2.f, y1 = centre.y + size.y / 2.f;
+    float z0 = centre.z - size.z / 2.f, z1 = centre.z + size.z / 2.f;
+    Vector3 corners[8] = {{x0, y0, z0}, {x1, y0, z0}, {x1, y0, z1}, {x0, y0, z1},
+                          {x0, y1, z0}, {x1, y1, z0}, {x1, y1, z1}, {x0, y1, z1}};
+    // Bottom ring, top ring, then the four uprights
+    constexpr int edges[boxLineVertices / 2][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0},
+                                                   {4, 5}, {5, 6}, {6, 7}, {7, 4},
+                                                   {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+    for (const auto &edge : edges)
+    {
+        pushVertex(lines, lineRgba, corners[edge[0]], color);
+        pushVertex(lines, lineRgba, corners[edge[1]], color);
+    }
+}
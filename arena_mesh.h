@@ -0,0 +1,53 @@
+/**
+ * Static arena geometry baked into flat vertex arrays - the ground plane,
+ * the four walls and every column as coloured triangles, plus the column
+ * outlines as lines. CPU side only; the front end uploads the triangles
+ * once as a mesh and both draw as a fixed number of calls no matter how
+ * many columns there are. Rebaked only when the sim's arena changes.
+*/
+
+#ifndef GGJ24_ARENA_MESH_H
+#define GGJ24_ARENA_MESH_H
+
+#include "raylib.h"
+
+#include <vector>
+
+struct SimSnapshot;
+
+class ArenaMesh
+{
+public:
+    // Rebuilds from the snapshot's arena if it changed since the last bake, returns whether it did
+    bool bake(const SimSnapshot &sim);
+
+    // Sim::arenaRevision this was baked from, -1 before the first bake
+    int revision() const { return bakedRevision; }
+
+    // [-------------- TRIANGLES -----------------------]
+    // xyz per vertex, rgba per vertex, three vertices per triangle
+    const std::vector<float> &triangleVertices() const { return triangles; }
+    const std::vector<unsigned char> &triangleColors() const { return triangleRgba; }
+    int triangleVertexCount() const { return static_cast<int>(triangles.size() / 3); }
+
+    // [-------------- LINES -----------------------]
+    // Same layout, two vertices per line. Column i's outline is the
+    // boxLineVertices vertices from i * boxLineVertices
+    static constexpr int boxLineVertices{24};
+    const std::vector<float> &lineVertices() const { return lines; }
+    const std::vector<unsigned char> &lineColors() const { return lineRgba; }
+    int lineVertexCount() const { return static_cast<int>(lines.size() / 3); }
+
+private:
+    void addQuad(Vector3 a, Vector3 b, Vector3 c, Vector3 d, Color color);
+    void addBox(Vector3 centre, Vector3 size, Color color);
+    void addBoxWires(Vector3 centre, Vector3 size, Color color);
+
+    std::vector<float> triangles;
+    std::vector<unsigned char> triangleRgba;
+    std::vector<float> lines;
+    std::vector<unsigned char> lineRgba;
+    int bakedRevision{-1};
+};
+
+#endif //GGJ24_ARENA_MESH_H
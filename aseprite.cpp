@@ -0,0 +1,761 @@
+#include "aseprite.h"
+
+#include <algorithm>
+
+// Biggest chunk we will buffer, far beyond any sprite sheet this game has
+constexpr uint32_t maxChunkSize{64u << 20};
+
+// [-------------- INFLATE -----------------------]
+// A small RFC 1951 decoder in the style of zlib's puff.c - Aseprite
+// compresses cels with plain zlib and the pipeline has no zlib to link
+
+namespace
+{
+struct BitStream
+{
+    const unsigned char *in;
+    size_t size;
+    size_t pos{0};
+    uint32_t buffer{0};
+    int count{0};
+    bool overrun{false};
+
+    int bits(int need)
+    {
+        uint32_t value = buffer;
+        while (count < need)
+        {
+            if (pos == size)
+            {
+                overrun = true;
+                return 0;
+            }
+            value |= static_cast<uint32_t>(in[pos++]) << count;
+            count += 8;
+        }
+        buffer = value >> need;
+        count -= need;
+        return static_cast<int>(value & ((1u << need) - 1));
+    }
+};
+
+struct Huffman
+{
+    short count[16];            // codes of each length
+    short symbol[288];          // symbols ordered by code
+};
+}
+
+// Canonical code from per-symbol lengths. 0 for a complete code, > 0 for
+// an incomplete one, < 0 if over-subscribed
+static int buildHuffman(Huffman &huffman, const short *lengths, int symbols)
+{
+    std::fill(std::begin(huffman.count), std::end(huffman.count), 0);
+    for (int s = 0; s < symbols; s++)
+    {
+        huffman.count[lengths[s]]++;
+    }
+    if (huffman.count[0] == symbols)
+    {
+        return 0;
+    }
+    int left = 1;
+    for (int length = 1; length < 16; length++)
+    {
+        left <<= 1;
+        left -= huffman.count[length];
+        if (left < 0)
+        {
+            return left;
+        }
+    }
+    short offsets[16];
+    offsets[1] = 0;
+    for (int length = 1; length < 15; length++)
+    {
+        offsets[length + 1] = static_cast<short>(offsets[length] + huffman.count[length]);
+    }
+    for (int s = 0; s < symbols; s++)
+    {
+        if (lengths[s] != 0)
+        {
+            huffman.symbol[offsets[lengths[s]]++] = static_cast<short>(s);
+        }
+    }
+    return left;
+}
+
+static int decodeSymbol(BitStream &stream, const Huffman &huffman)
+{
+    int code = 0, first = 0, index = 0;
+    for (int length = 1; length < 16; length++)
+    {
+        code |= stream.bits(1);
+        int count = huffman.count[length];
+        if (code - count < first)
+        {
+            return huffman.symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static bool inflateCodes(BitStream &stream, std::vector<unsigned char> &out, size_t &written,
+                         const Huffman &lengthCode, const Huffman &distanceCode)
+{
+    static const short lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const short lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const short distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                           257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                           8193, 12289, 16385, 24577};
+    static const short distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    while (true)
+    {
+        int symbol = decodeSymbol(stream, lengthCode);
+        if (symbol < 0 || stream.overrun)
+        {
+            return false;
+        }
+        if (symbol < 256)
+        {
+            if (written == out.size())
+            {
+                return false;
+            }
+            out[written++] = static_cast<unsigned char>(symbol);
+            continue;
+        }
+        if (symbol == 256)
+        {
+            return true;
+        }
+        symbol -= 257;
+        if (symbol >= 29)
+        {
+            return false;
+        }
+        size_t length = lengthBase[symbol] + stream.bits(lengthExtra[symbol]);
+        int distanceSymbol = decodeSymbol(stream, distanceCode);
+        if (distanceSymbol < 0 || distanceSymbol >= 30)
+        {
+            return false;
+        }
+        size_t distance = distanceBase[distanceSymbol] + stream.bits(distanceExtra[distanceSymbol]);
+        if (stream.overrun || distance > written || length > out.size() - written)
+        {
+            return false;
+        }
+        // Byte by byte, the source may overlap what is being written
+        for (; length > 0; length--, written++)
+        {
+            out[written] = out[written - distance];
+        }
+    }
+}
+
+static bool inflateStored(BitStream &stream, std::vector<unsigned char> &out, size_t &written)
+{
+    stream.buffer = 0;
+    stream.count = 0;
+    if (stream.size - stream.pos < 4)
+    {
+        return false;
+    }
+    const unsigned char *header = stream.in + stream.pos;
+    unsigned length = header[0] | (header[1] << 8);
+    if (static_cast<unsigned>(header[2] | (header[3] << 8)) != (~length & 0xffff))
+    {
+        return false;
+    }
+    stream.pos += 4;
+    if (length > stream.size - stream.pos || length > out.size() - written)
+    {
+        return false;
+    }
+    std::copy_n(stream.in + stream.pos, length, out.begin() + static_cast<long>(written));
+    stream.pos += length;
+    written += length;
+    return true;
+}
+
+static bool inflateFixed(BitStream &stream, std::vector<unsigned char> &out, size_t &written)
+{
+    static Huffman lengthCode, distanceCode;
+    static bool built = false;
+    if (!built)
+    {
+        short lengths[288];
+        std::fill(lengths, lengths + 144, 8);
+        std::fill(lengths + 144, lengths + 256, 9);
+        std::fill(lengths + 256, lengths + 280, 7);
+        std::fill(lengths + 280, lengths + 288, 8);
+        buildHuffman(lengthCode, lengths, 288);
+        std::fill(lengths, lengths + 30, 5);
+        buildHuffman(distanceCode, lengths, 30);
+        built = true;
+    }
+    return inflateCodes(stream, out, written, lengthCode, distanceCode);
+}
+
+static bool inflateDynamic(BitStream &stream, std::vector<unsigned char> &out, size_t &written)
+{
+    static const short order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    int lengthCount = stream.bits(5) + 257;
+    int distanceCount = stream.bits(5) + 1;
+    int codeCount = stream.bits(4) + 4;
+    if (stream.overrun || lengthCount > 286 || distanceCount > 30)
+    {
+        return false;
+    }
+
+    short lengths[320]{};
+    for (int i = 0; i < codeCount; i++)
+    {
+        lengths[order[i]] = static_cast<short>(stream.bits(3));
+    }
+    Huffman lengthCode, distanceCode;
+    if (buildHuffman(lengthCode, lengths, 19) != 0)
+    {
+        return false;
+    }
+
+    int index = 0;
+    while (index < lengthCount + distanceCount)
+    {
+        int symbol = decodeSymbol(stream, lengthCode);
+        if (symbol < 0 || stream.overrun)
+        {
+            return false;
+        }
+        if (symbol < 16)
+        {
+            lengths[index++] = static_cast<short>(symbol);
+            continue;
+        }
+        short repeated = 0;
+        int repeat;
+        if (symbol == 16)
+        {
+            if (index == 0)
+            {
+                return false;
+            }
+            repeated = lengths[index - 1];
+            repeat = 3 + stream.bits(2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + stream.bits(3);
+        }
+        else
+        {
+            repeat = 11 + stream.bits(7);
+        }
+        if (index + repeat > lengthCount + distanceCount)
+        {
+            return false;
+        }
+        std::fill(lengths + index, lengths + index + repeat, repeated);
+        index += repeat;
+    }
+    if (lengths[256] == 0)
+    {
+        return false;
+    }
+    // Incomplete codes are only allowed for a single length
+    int error = buildHuffman(lengthCode, lengths, lengthCount);
+    if (error < 0 || (error > 0 && lengthCount - lengthCode.count[0] != 1))
+    {
+        return false;
+    }
+    error = buildHuffman(distanceCode, lengths + lengthCount, distanceCount);
+    if (error < 0 || (error > 0 && distanceCount - distanceCode.count[0] != 1))
+    {
+        return false;
+    }
+    return inflateCodes(stream, out, written, lengthCode, distanceCode);
+}
+
+bool inflateZlib(const unsigned char *in, size_t inSize, std::vector<unsigned char> &out)
+{
+    // CMF / FLG: deflate, header checksum, no preset dictionary. The adler32 trailer is not checked
+    if (inSize < 2 || (in[0] & 0x0f) != 8 || (in[0] * 256 + in[1]) % 31 != 0 || (in[1] & 0x20) != 0)
+    {
+        return false;
+    }
+    BitStream stream{in + 2, inSize - 2};
+    size_t written = 0;
+    bool last = false;
+    while (!last)
+    {
+        last = stream.bits(1) != 0;
+        int type = stream.bits(2);
+        bool ok = false;
+        if (type == 0)
+        {
+            ok = inflateStored(stream, out, written);
+        }
+        else if (type == 1)
+        {
+            ok = inflateFixed(stream, out, written);
+        }
+        else if (type == 2)
+        {
+            ok = inflateDynamic(stream, out, written);
+        }
+        if (!ok || stream.overrun)
+        {
+            return false;
+        }
+    }
+    return written == out.size();
+}
+
+// [-------------- CHUNK FIELDS -----------------------]
+// Little-endian reads off a chunk, anything past the end reads as 0 and clears ok
+
+namespace
+{
+struct Fields
+{
+    const std::vector<unsigned char> &data;
+    size_t pos{0};
+    bool ok{true};
+
+    bool has(size_t bytes)
+    {
+        ok = ok && bytes <= data.size() - std::min(pos, data.size());
+        return ok;
+    }
+    int byte()
+    {
+        return has(1) ? data[pos++] : 0;
+    }
+    int word()
+    {
+        if (!has(2))
+        {
+            return 0;
+        }
+        int value = data[pos] | (data[pos + 1] << 8);
+        pos += 2;
+        return value;
+    }
+    int shortValue()
+    {
+        return static_cast<int16_t>(word());
+    }
+    uint32_t dword()
+    {
+        if (!has(4))
+        {
+            return 0;
+        }
+        uint32_t value = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) | (static_cast<uint32_t>(data[pos + 3]) << 24);
+        pos += 4;
+        return value;
+    }
+    std::string string()
+    {
+        size_t length = word();
+        if (!has(length))
+        {
+            return {};
+        }
+        std::string value(reinterpret_cast<const char *>(data.data() + pos), length);
+        pos += length;
+        return value;
+    }
+    void skip(size_t bytes)
+    {
+        if (has(bytes))
+        {
+            pos += bytes;
+        }
+    }
+};
+}
+
+// [-------------- READER -----------------------]
+
+AsepriteReader::~AsepriteReader()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+}
+
+bool AsepriteReader::fail(const char *message)
+{
+    lastError = message;
+    return false;
+}
+
+bool AsepriteReader::open(const char *path)
+{
+    file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return fail("can't open file");
+    }
+    std::vector<unsigned char> header(128);
+    if (fread(header.data(), 1, header.size(), file) != header.size())
+    {
+        return fail("truncated header");
+    }
+    Fields fields{header};
+    fields.dword();             // file size
+    if (fields.word() != 0xA5E0)
+    {
+        return fail("not an Aseprite file");
+    }
+    frames = fields.word();
+    canvasWidth = fields.word();
+    canvasHeight = fields.word();
+    depth = fields.word();
+    layerOpacityValid = (fields.dword() & 1) != 0;
+    fields.skip(2 + 4 + 4);     // speed, two reserved dwords
+    transparentIndex = fields.byte();
+    if (depth != 32 && depth != 16 && depth != 8)
+    {
+        return fail("unknown colour depth");
+    }
+    if (canvasWidth <= 0 || canvasHeight <= 0)
+    {
+        return fail("empty canvas");
+    }
+    celOffsets.assign(frames, {});
+    return true;
+}
+
+bool AsepriteReader::readChunk(uint32_t &type, std::vector<unsigned char> &data)
+{
+    unsigned char header[6];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        return fail("truncated chunk");
+    }
+    uint32_t size = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    type = header[4] | (header[5] << 8);
+    if (size < sizeof(header) || size > maxChunkSize)
+    {
+        return fail("bad chunk size");
+    }
+    data.resize(size - sizeof(header));
+    if (fread(data.data(), 1, data.size(), file) != data.size())
+    {
+        return fail("truncated chunk");
+    }
+    return true;
+}
+
+bool AsepriteReader::nextFrame(AseFrame &frame)
+{
+    if (file == nullptr || nextFrameIndex >= frames)
+    {
+        return false;
+    }
+    int index = nextFrameIndex++;
+    long frameStart = ftell(file);
+    unsigned char header[16];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        return fail("truncated frame");
+    }
+    uint32_t frameBytes = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    if ((header[4] | (header[5] << 8)) != 0xF1FA)
+    {
+        return fail("bad frame magic");
+    }
+    uint32_t chunks = header[6] | (header[7] << 8);
+    uint32_t newChunks = header[12] | (header[13] << 8) | (header[14] << 16) | (static_cast<uint32_t>(header[15]) << 24);
+    if (newChunks != 0)
+    {
+        chunks = newChunks;
+    }
+    frame.durationMs = header[8] | (header[9] << 8);
+
+    std::vector<Cel> cels;
+    for (uint32_t c = 0; c < chunks; c++)
+    {
+        long offset = ftell(file);
+        uint32_t type;
+        if (!readChunk(type, chunk))
+        {
+            return false;
+        }
+        switch (type)
+        {
+            case 0x2004:
+                readLayer(chunk);
+                break;
+            case 0x2005:
+            {
+                Cel cel{};
+                if (!readCel(chunk, index, cel))
+                {
+                    return false;
+                }
+                auto &offsets = celOffsets[index];
+                offsets.resize(std::max(offsets.size(), static_cast<size_t>(cel.layer + 1)), -1);
+                offsets[cel.layer] = offset;
+                if (cel.width > 0)
+                {
+                    cels.push_back(std::move(cel));
+                }
+                break;
+            }
+            case 0x2018:
+                readTags(chunk);
+                break;
+            case 0x2019:
+                readPalette(chunk);
+                break;
+            case 0x0004:
+                readOldPalette(chunk);
+                break;
+            default:
+                // Colour profile, slices, user data, tilesets... nothing the atlas needs
+                break;
+        }
+    }
+    // Whatever the chunk count said, the next frame starts where this one's size says
+    fseek(file, frameStart + static_cast<long>(frameBytes), SEEK_SET);
+
+    composite(cels, frame);
+    return true;
+}
+
+void AsepriteReader::readLayer(const std::vector<unsigned char> &data)
+{
+    Fields fields{data};
+    int flags = fields.word();
+    Layer layer{};
+    layer.type = fields.word();
+    layer.childLevel = fields.word();
+    fields.skip(2 + 2 + 2);     // default size, blend mode (all cels blend as normal)
+    layer.opacity = fields.byte();
+    layer.background = (flags & 8) != 0;
+    // Hidden, or a reference layer, or inside a hidden group
+    layer.visible = (flags & 1) != 0 && (flags & 64) == 0;
+    for (auto parent = layers.rbegin(); parent != layers.rend() && layer.childLevel > 0; ++parent)
+    {
+        if (parent->childLevel == layer.childLevel - 1)
+        {
+            layer.visible = layer.visible && parent->visible;
+            break;
+        }
+    }
+    layers.push_back(layer);
+}
+
+bool AsepriteReader::readCel(const std::vector<unsigned char> &data, int frame, Cel &cel)
+{
+    Fields fields{data};
+    cel.layer = fields.word();
+    cel.x = fields.shortValue();
+    cel.y = fields.shortValue();
+    cel.opacity = fields.byte();
+    int type = fields.word();
+    cel.zIndex = fields.shortValue();
+    fields.skip(5);
+    if (!fields.ok || cel.layer >= static_cast<int>(layers.size()))
+    {
+        return fail("bad cel");
+    }
+    const Layer &layer = layers[cel.layer];
+
+    if (type == 1)
+    {
+        // Linked - same cel as an earlier frame. Go back and decode that one
+        int linked = fields.word();
+        if (!fields.ok || linked >= frame || cel.layer >= static_cast<int>(celOffsets[linked].size()) ||
+            celOffsets[linked][cel.layer] < 0)
+        {
+            return fail("bad linked cel");
+        }
+        long resume = ftell(file);
+        std::vector<unsigned char> original;
+        uint32_t originalType;
+        fseek(file, celOffsets[linked][cel.layer], SEEK_SET);
+        bool ok = readChunk(originalType, original) && readCel(original, linked, cel);
+        fseek(file, resume, SEEK_SET);
+        return ok;
+    }
+    if (type == 3 || !layer.visible || layer.type != 0)
+    {
+        // Tilemaps are not supported, hidden layers and groups draw nothing
+        cel.width = 0;
+        return true;
+    }
+    if (type != 0 && type != 2)
+    {
+        return fail("unknown cel type");
+    }
+    cel.width = fields.word();
+    cel.height = fields.word();
+    if (!fields.ok)
+    {
+        return fail("bad cel");
+    }
+    return decodeCelPixels(data.data() + fields.pos, data.size() - fields.pos, type == 2, cel);
+}
+
+bool AsepriteReader::decodeCelPixels(const unsigned char *pixels, size_t size, bool compressed, Cel &cel)
+{
+    size_t bytesPerPixel = static_cast<size_t>(depth / 8);
+    size_t count = static_cast<size_t>(cel.width) * cel.height;
+    std::vector<unsigned char> raw;
+    if (compressed)
+    {
+        raw.resize(count * bytesPerPixel);
+        if (!inflateZlib(pixels, size, raw))
+        {
+            return fail("bad compressed cel");
+        }
+        pixels = raw.data();
+    }
+    else if (size < count * bytesPerPixel)
+    {
+        return fail("truncated cel");
+    }
+
+    bool background = layers[cel.layer].background;
+    cel.rgba.resize(count * 4);
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char *out = &cel.rgba[i * 4];
+        if (depth == 32)
+        {
+            std::copy_n(pixels + i * 4, 4, out);
+        }
+        else if (depth == 16)
+        {
+            out[0] = out[1] = out[2] = pixels[i * 2];
+            out[3] = pixels[i * 2 + 1];
+        }
+        else
+        {
+            int index = pixels[i];
+            uint32_t colour = (index == transparentIndex && !background) ? 0 : palette[index];
+            out[0] = colour & 0xff;
+            out[1] = (colour >> 8) & 0xff;
+            out[2] = (colour >> 16) & 0xff;
+            out[3] = colour >> 24;
+        }
+    }
+    return true;
+}
+
+void AsepriteReader::readTags(const std::vector<unsigned char> &data)
+{
+    Fields fields{data};
+    int count = fields.word();
+    fields.skip(8);
+    for (int t = 0; t < count && fields.ok; t++)
+    {
+        AseTag tag{};
+        tag.from = fields.word();
+        tag.to = fields.word();
+        tag.direction = fields.byte();
+        tag.repeat = fields.word();
+        fields.skip(6 + 3 + 1);     // reserved, colour, extra byte
+        tag.name = fields.string();
+        if (fields.ok)
+        {
+            tagList.push_back(std::move(tag));
+        }
+    }
+}
+
+void AsepriteReader::readPalette(const std::vector<unsigned char> &data)
+{
+    Fields fields{data};
+    fields.dword();             // new palette size
+    uint32_t first = fields.dword();
+    uint32_t last = fields.dword();
+    fields.skip(8);
+    for (uint32_t i = first; i <= last && i < 256 && fields.ok; i++)
+    {
+        int flags = fields.word();
+        uint32_t r = fields.byte(), g = fields.byte(), b = fields.byte(), a = fields.byte();
+        if (flags & 1)
+        {
+            fields.string();
+        }
+        palette[i] = r | (g << 8) | (b << 16) | (a << 24);
+    }
+    newPalette = true;
+}
+
+void AsepriteReader::readOldPalette(const std::vector<unsigned char> &data)
+{
+    // Older files only, newer ones write both and the new chunk wins
+    if (newPalette)
+    {
+        return;
+    }
+    Fields fields{data};
+    int packets = fields.word();
+    int index = 0;
+    for (int p = 0; p < packets && fields.ok; p++)
+    {
+        index += fields.byte();
+        int colours = fields.byte();
+        colours = colours == 0 ? 256 : colours;
+        for (int c = 0; c < colours && fields.ok; c++, index++)
+        {
+            uint32_t r = fields.byte(), g = fields.byte(), b = fields.byte();
+            if (index < 256)
+            {
+                palette[index] = r | (g << 8) | (b << 16) | (255u << 24);
+            }
+        }
+    }
+}
+
+void AsepriteReader::composite(std::vector<Cel> &cels, AseFrame &frame) const
+{
+    // Aseprite's order: layer index plus z-index, z-index breaks ties
+    std::stable_sort(cels.begin(), cels.end(), [](const Cel &a, const Cel &b)
+    {
+        int orderA = a.layer + a.zIndex, orderB = b.layer + b.zIndex;
+        return orderA != orderB ? orderA < orderB : a.zIndex < b.zIndex;
+    });
+
+    frame.rgba.assign(static_cast<size_t>(canvasWidth) * canvasHeight * 4, 0);
+    for (const Cel &cel : cels)
+    {
+        int layerOpacity = layerOpacityValid ? layers[cel.layer].opacity : 255;
+        int opacity = cel.opacity * layerOpacity / 255;
+        for (int y = std::max(0, -cel.y); y < cel.height && cel.y + y < canvasHeight; y++)
+        {
+            for (int x = std::max(0, -cel.x); x < cel.width && cel.x + x < canvasWidth; x++)
+            {
+                const unsigned char *source = &cel.rgba[(static_cast<size_t>(y) * cel.width + x) * 4];
+                unsigned char *target = &frame.rgba[(static_cast<size_t>(cel.y + y) * canvasWidth + cel.x + x) * 4];
+                // Straight alpha source-over
+                int sourceAlpha = source[3] * opacity / 255;
+                if (sourceAlpha == 0)
+                {
+                    continue;
+                }
+                int targetAlpha = target[3] * (255 - sourceAlpha) / 255;
+                int alpha = sourceAlpha + targetAlpha;
+                for (int c = 0; c < 3; c++)
+                {
+                    target[c] = static_cast<unsigned char>((source[c] * sourceAlpha + target[c] * targetAlpha) / alpha);
+                }
+                target[3] = static_cast<unsigned char>(alpha);
+            }
+        }
+    }
+}
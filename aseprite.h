@@ -0,0 +1,107 @@
+/**
+ * Streaming Aseprite (.ase / .aseprite) reader for the asset pipeline.
+ * Walks the file a frame and a chunk at a time - only the current chunk and
+ * the frame being composited are held in memory - and flattens each frame's
+ * visible layers into RGBA with their durations, plus the file's tags.
+ * RGBA, grayscale and indexed sprites; compressed cels are inflated here so
+ * the pipeline needs no zlib. Tilemap layers are skipped.
+*/
+
+#ifndef GGJ24_ASEPRITE_H
+#define GGJ24_ASEPRITE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct AseTag
+{
+    std::string name;
+    int from;
+    int to;
+    int direction;              // 0 forward, 1 reverse, 2 ping-pong, 3 ping-pong reverse
+    int repeat;                 // 0 forever
+};
+
+struct AseFrame
+{
+    int durationMs{100};
+    std::vector<unsigned char> rgba;    // width * height * 4, straight alpha
+};
+
+class AsepriteReader
+{
+public:
+    AsepriteReader() = default;
+    AsepriteReader(const AsepriteReader &) = delete;
+    AsepriteReader &operator=(const AsepriteReader &) = delete;
+    ~AsepriteReader();
+
+    // Reads the file header, false (see error()) if path is not an Aseprite file
+    bool open(const char *path);
+
+    int width() const { return canvasWidth; }
+    int height() const { return canvasHeight; }
+    int frameCount() const { return frames; }
+
+    // Decodes and flattens the next frame. False at the end or on a broken file
+    bool nextFrame(AseFrame &frame);
+
+    // Filled in as the chunks carrying them are read - Aseprite writes both in frame 0
+    const std::vector<AseTag> &tags() const { return tagList; }
+    const char *error() const { return lastError.c_str(); }
+
+private:
+    struct Layer
+    {
+        bool visible;           // own flag and every parent group's
+        int type;
+        int childLevel;
+        int opacity;
+        bool background;
+    };
+
+    struct Cel
+    {
+        int layer;
+        int x, y;
+        int opacity;
+        int zIndex;
+        int width, height;
+        std::vector<unsigned char> rgba;
+    };
+
+    bool fail(const char *message);
+    bool readChunk(uint32_t &type, std::vector<unsigned char> &data);
+    bool readCel(const std::vector<unsigned char> &data, int frame, Cel &cel);
+    bool decodeCelPixels(const unsigned char *pixels, size_t size, bool compressed, Cel &cel);
+    void readLayer(const std::vector<unsigned char> &data);
+    void readTags(const std::vector<unsigned char> &data);
+    void readPalette(const std::vector<unsigned char> &data);
+    void readOldPalette(const std::vector<unsigned char> &data);
+    void composite(std::vector<Cel> &cels, AseFrame &frame) const;
+
+    FILE *file{nullptr};
+    std::string lastError;
+    int frames{0};
+    int nextFrameIndex{0};
+    int canvasWidth{0};
+    int canvasHeight{0};
+    int depth{32};
+    int transparentIndex{0};
+    bool layerOpacityValid{false};
+    bool newPalette{false};
+
+    std::vector<Layer> layers;
+    uint32_t palette[256]{};
+    std::vector<AseTag> tagList;
+    // File offset of every cel chunk by [frame][layer], -1 if none, for linked cels
+    std::vector<std::vector<long>> celOffsets;
+    std::vector<unsigned char> chunk;
+};
+
+// Raw DEFLATE with a zlib header and trailer around it, into exactly out.size() bytes
+bool inflateZlib(const unsigned char *in, size_t inSize, std::vector<unsigned char> &out);
+
+#endif //GGJ24_ASEPRITE_H
@@ -0,0 +1,79 @@
+#include "asset_loader.h"
+
+#include <algorithm>
+#include <utility>
+
+AssetLoader::AssetLoader(TextureCache &cache, std::vector<std::string> paths)
+    : cache(cache), paths(std::move(paths)), handles(this->paths.size())
+{
+    int threads = std::min(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())),
+                           static_cast<int>(this->paths.size()));
+    for (int i = 0; i < threads; i++)
+    {
+        workers.emplace_back(&AssetLoader::work, this);
+    }
+}
+
+AssetLoader::~AssetLoader()
+{
+    stopping = true;
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    for (Decoded &decoded : ready)
+    {
+        if (decoded.ok)
+        {
+            UnloadImage(decoded.image.image);
+        }
+    }
+}
+
+void AssetLoader::work()
+{
+    for (int index = next++; index < static_cast<int>(paths.size()) && !stopping; index = next++)
+    {
+        Decoded decoded{index, false, {}};
+        decoded.ok = TextureCache::decode(paths[index].c_str(), decoded.image);
+        std::lock_guard lock(readyMutex);
+        ready.push_back(std::move(decoded));
+    }
+}
+
+bool AssetLoader::pump(double budgetSeconds)
+{
+    double start = GetTime();
+    while (!done())
+    {
+        Decoded decoded;
+        {
+            std::lock_guard lock(readyMutex);
+            if (ready.empty())
+            {
+                break;
+            }
+            decoded = std::move(ready.front());
+            ready.pop_front();
+        }
+        if (decoded.ok)
+        {
+            handles[decoded.index] = cache.upload(paths[decoded.index].c_str(), decoded.image);
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "ASSETS: Failed to load %s", paths[decoded.index].c_str());
+        }
+        finished++;
+        if (GetTime() - start >= budgetSeconds)
+        {
+            break;
+        }
+    }
+    return done();
+}
+
+float AssetLoader::progress() const
+{
+    return paths.empty() ? 1.f : static_cast<float>(finished) / static_cast<float>(paths.size());
+}
@@ -0,0 +1,63 @@
+/**
+ * Asynchronous texture loading. Files are read and decoded on a pool of
+ * worker threads while the GL thread keeps drawing frames, and pump()
+ * uploads whatever is ready each frame within a time budget. Cold start is
+ * bound by the slowest decode per core instead of the sum of all of them.
+*/
+
+#ifndef GGJ24_ASSET_LOADER_H
+#define GGJ24_ASSET_LOADER_H
+
+#include "texture_cache.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AssetLoader
+{
+public:
+    // Starts decoding every path, on up to one worker per core
+    AssetLoader(TextureCache &cache, std::vector<std::string> paths);
+    // Stops the workers and frees anything decoded but not uploaded yet
+    ~AssetLoader();
+    AssetLoader(const AssetLoader &) = delete;
+    AssetLoader &operator=(const AssetLoader &) = delete;
+
+    // GL thread, once a frame: uploads decoded textures until budgetSeconds
+    // has gone (always at least one). True once every path is done
+    bool pump(double budgetSeconds);
+
+    bool done() const { return finished == static_cast<int>(paths.size()); }
+    // Fraction of the paths uploaded (or failed), for a progress display
+    float progress() const;
+    // paths[index] once it is uploaded, null before that or if it failed
+    const TextureHandle &handle(int index) const { return handles[index]; }
+
+private:
+    struct Decoded
+    {
+        int index;
+        bool ok;
+        DecodedImage image;
+    };
+
+    void work();
+
+    TextureCache &cache;
+    std::vector<std::string> paths;
+    std::vector<TextureHandle> handles;
+    int finished{0};
+
+    // Workers take paths in order off next, and hand results to the GL thread through ready
+    std::atomic<int> next{0};
+    std::atomic<bool> stopping{false};
+    std::mutex readyMutex;
+    std::deque<Decoded> ready;
+    std::vector<std::thread> workers;
+};
+
+#endif //GGJ24_ASSET_LOADER_H
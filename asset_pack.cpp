@@ -0,0 +1,197 @@
+#include "asset_pack.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr char packMagic[8] = "GGJ24PK";
+// Blob alignment - a cache line, more than any pixel format needs
+static constexpr uint64_t blobAlignment{64};
+
+static uint64_t alignUp(uint64_t value)
+{
+    return (value + blobAlignment - 1) / blobAlignment * blobAlignment;
+}
+
+uint64_t assetPackHash(const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// [-------------- WRITER -----------------------]
+
+bool AssetPackWriter::add(const std::string &name, const void *pixels, size_t size, int width, int height, int format, int mipmaps)
+{
+    AssetPackEntry entry{};
+    if (name.size() >= sizeof(entry.name))
+    {
+        return false;
+    }
+    memcpy(entry.name, name.c_str(), name.size());
+    entry.hash = assetPackHash(pixels, size);
+    entry.size = size;
+    entry.width = width;
+    entry.height = height;
+    entry.format = format;
+    entry.mipmaps = mipmaps;
+    entries.push_back(entry);
+    const auto *bytes = static_cast<const unsigned char *>(pixels);
+    blobs.emplace_back(bytes, bytes + size);
+    return true;
+}
+
+bool AssetPackWriter::write(const char *path) const
+{
+    // Offsets first, then everything out in one pass
+    std::vector<AssetPackEntry> table = entries;
+    uint64_t offset = alignUp(sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * table.size());
+    for (AssetPackEntry &entry : table)
+    {
+        entry.offset = offset;
+        offset = alignUp(offset + entry.size);
+    }
+
+    AssetPackHeader header{};
+    memcpy(header.magic, packMagic, sizeof(packMagic));
+    header.version = assetPackVersion;
+    header.entryCount = static_cast<uint32_t>(table.size());
+    header.fileSize = offset;
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    static const unsigned char zeros[blobAlignment]{};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(table.data(), sizeof(AssetPackEntry), table.size(), file) == table.size();
+    uint64_t written = sizeof(header) + sizeof(AssetPackEntry) * table.size();
+    for (size_t i = 0; ok && i < table.size(); i++)
+    {
+        ok = fwrite(zeros, 1, table[i].offset - written, file) == table[i].offset - written;
+        ok = ok && fwrite(blobs[i].data(), 1, blobs[i].size(), file) == blobs[i].size();
+        written = table[i].offset + table[i].size;
+    }
+    ok = ok && fwrite(zeros, 1, header.fileSize - written, file) == header.fileSize - written;
+    return fclose(file) == 0 && ok;
+}
+
+// [-------------- READER -----------------------]
+
+AssetPack::~AssetPack()
+{
+    close();
+}
+
+bool AssetPack::open(const char *path)
+{
+    close();
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    contents.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    bool read = fread(contents.data(), 1, contents.size(), file) == contents.size();
+    fclose(file);
+    if (!read || contents.empty())
+    {
+        contents.clear();
+        return false;
+    }
+    base = contents.data();
+    mappedSize = contents.size();
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive on its own
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    base = static_cast<const unsigned char *>(mapping);
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // Everything the index claims has to be inside the file
+    const auto *header = reinterpret_cast<const AssetPackHeader *>(base);
+    bool valid = mappedSize >= sizeof(AssetPackHeader) &&
+                 memcmp(header->magic, packMagic, sizeof(packMagic)) == 0 &&
+                 header->version == assetPackVersion &&
+                 header->fileSize == mappedSize &&
+                 sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * static_cast<uint64_t>(header->entryCount) <= mappedSize;
+    if (valid)
+    {
+        table = reinterpret_cast<const AssetPackEntry *>(base + sizeof(AssetPackHeader));
+        count = static_cast<int>(header->entryCount);
+        for (int i = 0; i < count && valid; i++)
+        {
+            valid = table[i].offset <= mappedSize && table[i].size <= mappedSize - table[i].offset &&
+                    table[i].name[sizeof(table[i].name) - 1] == '\0';
+        }
+    }
+    if (!valid)
+    {
+        close();
+    }
+    return valid;
+}
+
+void AssetPack::close()
+{
+#ifdef _WIN32
+    contents.clear();
+#else
+    if (base != nullptr)
+    {
+        munmap(const_cast<unsigned char *>(base), mappedSize);
+    }
+#endif
+    base = nullptr;
+    mappedSize = 0;
+    table = nullptr;
+    count = 0;
+}
+
+int AssetPack::find(const char *name) const
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(table[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool AssetPack::verify(int index) const
+{
+    return assetPackHash(pixels(index), table[index].size) == table[index].hash;
+}
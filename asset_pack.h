@@ -0,0 +1,92 @@
+/**
+ * Binary asset pack - pre-decoded pixel data in one file, so the game never
+ * decompresses a PNG at startup. A header, an index of named entries with
+ * their size, pixel format and content hash, then the pixel blobs, each
+ * 64 byte aligned. The reader maps the file and hands out pointers into
+ * the mapping, which raylib can upload from directly. No GL needed either
+ * way, the writer runs in the build and the reader can run headless.
+*/
+
+#ifndef GGJ24_ASSET_PACK_H
+#define GGJ24_ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Bump whenever the layout below changes, old packs are then rejected
+constexpr uint32_t assetPackVersion{1};
+
+struct AssetPackHeader
+{
+    char magic[8];              // "GGJ24PK\0"
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t fileSize;
+};
+
+struct AssetPackEntry
+{
+    char name[96];              // what the runtime looks it up by, e.g. the PNG it replaces
+    uint64_t hash;              // FNV-1a of the pixel data
+    uint64_t offset;            // from the start of the file
+    uint64_t size;
+    int32_t width;
+    int32_t height;
+    int32_t format;             // raylib PixelFormat
+    int32_t mipmaps;
+};
+
+// 64-bit FNV-1a, the hash stored in the index
+uint64_t assetPackHash(const void *data, size_t size);
+
+// [-------------- WRITER -----------------------]
+class AssetPackWriter
+{
+public:
+    // Copies pixels, the caller can free them straight away. False if name is too long
+    bool add(const std::string &name, const void *pixels, size_t size, int width, int height, int format, int mipmaps = 1);
+    bool write(const char *path) const;
+
+private:
+    std::vector<AssetPackEntry> entries;
+    std::vector<std::vector<unsigned char>> blobs;
+};
+
+// [-------------- READER -----------------------]
+class AssetPack
+{
+public:
+    AssetPack() = default;
+    AssetPack(const AssetPack &) = delete;
+    AssetPack &operator=(const AssetPack &) = delete;
+    ~AssetPack();
+
+    // Maps path and checks the header and the index fit the file. False for a
+    // missing, truncated or other-version pack
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int entryCount() const { return count; }
+    const AssetPackEntry &entry(int index) const { return table[index]; }
+    // Index of the entry called name, -1 if there is none
+    int find(const char *name) const;
+    // Straight into the mapping, good until close()
+    const void *pixels(int index) const { return base + table[index].offset; }
+    // Rehashes an entry's pixels against the index - reads the whole blob
+    bool verify(int index) const;
+
+private:
+    const unsigned char *base{nullptr};
+    size_t mappedSize{0};
+#ifdef _WIN32
+    // No mmap here, the file is read in whole instead
+    std::vector<unsigned char> contents;
+#endif
+    const AssetPackEntry *table{nullptr};
+    int count{0};
+};
+
+#endif //GGJ24_ASSET_PACK_H
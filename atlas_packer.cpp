@@ -0,0 +1,600 @@
+/**
+ * Build-time sprite atlas packer.
+ * Packs every Aseprite file and PNG in an art directory into as few atlas
+ * pages as fit, one rectangle per animation frame, and writes the pages
+ * plus a header (atlas_frames.h) of frame rectangles, pages and tags for
+ * the front end. The frames and their durations are checked there against
+ * sprite_sheet.h, which the sim animates from. Uses a skyline
+ * bottom-left packer with a pixel of padding around each frame so
+ * filtering never samples a neighbour. The pages also go into atlas.pack,
+ * already decoded, for the game to map at startup.
+ *
+ * usage: GGJ24AtlasPacker <art dir> <page dir> <header> [NAME=file[:frames[:ms]] | --skip=file ...]
+ * Sprites are named after their file unless given a NAME. Aseprite files
+ * bring their own frames, durations and tags; a PNG is one frame, or a
+ * horizontal strip of :frames equal ones at :ms (defaultFrameMs) each. A
+ * one-frame Aseprite file drawn as a strip splits the same way, its frame
+ * duration standing in for a missing :ms. A PNG with the same name as an
+ * Aseprite file is taken for its export and left out, --skip leaves out
+ * any other file.
+*/
+
+#include "aseprite.h"
+#include "asset_pack.h"
+#include "raylib.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+constexpr int maxPageSize{2048};
+constexpr int minPageSize{64};
+constexpr int padding{1};
+// PNG frames have no timing of their own
+constexpr int defaultFrameMs{100};
+
+struct SourceSprite
+{
+    std::string file;
+    std::string name;       // SPRITE_ enum name
+    Image image{};              // every frame side by side
+    int frameCount{1};
+    std::vector<int> durations;
+    std::vector<AseTag> tags;
+};
+
+// What the command line says about one file
+struct FileOptions
+{
+    std::string name;
+    int frames{0};
+    int frameMs{0};
+    bool skip{false};
+    bool seen{false};
+};
+
+struct Frame
+{
+    int sprite;
+    int index;              // frame within the sprite
+    int width, height;
+    int page{-1};
+    int x{0}, y{0};
+};
+
+// [-------------- SKYLINE -----------------------]
+// The top edge of everything placed so far as a list of horizontal segments.
+// A new rectangle goes where it sits lowest, leftmost on ties.
+class Skyline
+{
+public:
+    explicit Skyline(int size) : size(size), segments{{0, 0, size}} {}
+
+    bool insert(int width, int height, int &outX, int &outY)
+    {
+        int bestY = size, bestWidth = size, bestIndex = -1;
+        for (int i = 0; i < static_cast<int>(segments.size()); i++)
+        {
+            int y;
+            if (fits(i, width, height, y) && (y < bestY || (y == bestY && segments[i].width < bestWidth)))
+            {
+                bestY = y;
+                bestWidth = segments[i].width;
+                bestIndex = i;
+            }
+        }
+        if (bestIndex < 0)
+        {
+            return false;
+        }
+        outX = segments[bestIndex].x;
+        outY = bestY;
+        place(bestIndex, outX, outY + height, width);
+        return true;
+    }
+
+private:
+    struct Segment
+    {
+        int x, y, width;
+    };
+
+    // Highest segment under [segments[i].x, +width), false if it runs off the page
+    bool fits(int i, int width, int height, int &y) const
+    {
+        int x = segments[i].x;
+        if (x + width > size)
+        {
+            return false;
+        }
+        y = 0;
+        for (int left = width; left > 0; i++)
+        {
+            y = std::max(y, segments[i].y);
+            left -= segments[i].width;
+        }
+        return y + height <= size;
+    }
+
+    void place(int i, int x, int top, int width)
+    {
+        segments.insert(segments.begin() + i, {x, top, width});
+        // Trim or drop the segments the new one now covers
+        for (size_t next = i + 1; next < segments.size();)
+        {
+            int overlap = x + width - segments[next].x;
+            if (overlap <= 0)
+            {
+                break;
+            }
+            segments[next].x += overlap;
+            segments[next].width -= overlap;
+            if (segments[next].width > 0)
+            {
+                break;
+            }
+            segments.erase(segments.begin() + next);
+        }
+        // Merge neighbours at the same height
+        for (size_t s = 0; s + 1 < segments.size();)
+        {
+            if (segments[s].y == segments[s + 1].y)
+            {
+                segments[s].width += segments[s + 1].width;
+                segments.erase(segments.begin() + s + 1);
+            }
+            else
+            {
+                s++;
+            }
+        }
+    }
+
+    int size;
+    std::vector<Segment> segments;
+};
+
+// Packs frames into one page of size, returns false if any does not fit
+static bool packPage(std::vector<Frame *> &frames, int size, int page)
+{
+    Skyline skyline(size);
+    for (Frame *frame : frames)
+    {
+        int x, y;
+        if (!skyline.insert(frame->width + 2 * padding, frame->height + 2 * padding, x, y))
+        {
+            return false;
+        }
+        frame->page = page;
+        frame->x = x + padding;
+        frame->y = y + padding;
+    }
+    return true;
+}
+
+static std::string enumName(const std::string &stem)
+{
+    std::string name = "SPRITE_";
+    for (char c : stem)
+    {
+        name += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    return name;
+}
+
+static bool isAseprite(const std::filesystem::path &file)
+{
+    return file.extension() == ".ase" || file.extension() == ".aseprite";
+}
+
+// Flattens every frame of an Aseprite file into one strip
+static bool loadAseprite(const std::filesystem::path &file, SourceSprite &sprite)
+{
+    AsepriteReader reader;
+    if (!reader.open(file.string().c_str()))
+    {
+        fprintf(stderr, "%s: %s\n", file.string().c_str(), reader.error());
+        return false;
+    }
+    int width = reader.width(), height = reader.height();
+    sprite.frameCount = reader.frameCount();
+    if (sprite.frameCount < 1)
+    {
+        fprintf(stderr, "%s has no frames\n", file.string().c_str());
+        return false;
+    }
+    sprite.image = GenImageColor(width * sprite.frameCount, height, BLANK);
+    auto *strip = static_cast<unsigned char *>(sprite.image.data);
+    AseFrame frame;
+    for (int f = 0; f < sprite.frameCount; f++)
+    {
+        if (!reader.nextFrame(frame))
+        {
+            fprintf(stderr, "%s frame %d: %s\n", file.string().c_str(), f, reader.error());
+            return false;
+        }
+        for (int row = 0; row < height; row++)
+        {
+            memcpy(strip + (static_cast<size_t>(row) * width * sprite.frameCount + static_cast<size_t>(f) * width) * 4,
+                   frame.rgba.data() + static_cast<size_t>(row) * width * 4, static_cast<size_t>(width) * 4);
+        }
+        sprite.durations.push_back(frame.durationMs);
+    }
+    sprite.tags = reader.tags();
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: %s <art dir> <page dir> <header> [NAME=file[:frames[:ms]] | --skip=file ...]\n", argv[0]);
+        return 1;
+    }
+    std::filesystem::path artDir = argv[1];
+    std::filesystem::path pageDir = argv[2];
+    const char *headerPath = argv[3];
+
+    std::map<std::string, FileOptions> options;
+    for (int i = 4; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument.rfind("--skip=", 0) == 0)
+        {
+            options[argument.substr(7)].skip = true;
+            continue;
+        }
+        size_t equals = argument.find('=');
+        size_t colon = argument.find(':', equals);
+        if (equals == std::string::npos || equals == 0)
+        {
+            fprintf(stderr, "bad argument '%s'\n", argv[i]);
+            return 1;
+        }
+        FileOptions &file = options[argument.substr(equals + 1, colon - equals - 1)];
+        file.name = argument.substr(0, equals);
+        if (colon != std::string::npos && (file.frames = atoi(argument.c_str() + colon + 1)) < 1)
+        {
+            fprintf(stderr, "bad frame count '%s'\n", argv[i]);
+            return 1;
+        }
+        size_t msColon = colon == std::string::npos ? colon : argument.find(':', colon + 1);
+        if (msColon != std::string::npos && (file.frameMs = atoi(argument.c_str() + msColon + 1)) < 1)
+        {
+            fprintf(stderr, "bad frame duration '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // [-------------- LOAD -----------------------]
+    // Sorted by name so the enum and the pages come out the same on every machine
+    std::vector<std::filesystem::path> files;
+    std::set<std::string> asepriteStems;
+    for (const auto &entry : std::filesystem::directory_iterator(artDir))
+    {
+        if (entry.is_regular_file() && (entry.path().extension() == ".png" || isAseprite(entry.path())))
+        {
+            files.push_back(entry.path());
+            if (isAseprite(entry.path()))
+            {
+                asepriteStems.insert(entry.path().stem().string());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    SetTraceLogLevel(LOG_WARNING);
+    std::vector<SourceSprite> sprites;
+    std::vector<Frame> frames;
+    for (const auto &file : files)
+    {
+        FileOptions &option = options[file.filename().string()];
+        option.seen = true;
+        bool isExport = !isAseprite(file) && asepriteStems.count(file.stem().string()) != 0;
+        if (option.skip || (isExport && option.name.empty()))
+        {
+            continue;
+        }
+
+        SourceSprite sprite;
+        sprite.file = file.filename().string();
+        sprite.name = enumName(option.name.empty() ? file.stem().string() : option.name);
+        if (isAseprite(file))
+        {
+            if (!loadAseprite(file, sprite))
+            {
+                return 1;
+            }
+            if (option.frames > 0 && option.frames != sprite.frameCount)
+            {
+                // Only a single frame can be cut up, anything else already has its frames
+                if (sprite.frameCount != 1 || sprite.image.width % option.frames != 0)
+                {
+                    fprintf(stderr, "%s has %d frame(s), it cannot be split into %d\n",
+                            sprite.file.c_str(), sprite.frameCount, option.frames);
+                    return 1;
+                }
+                sprite.frameCount = option.frames;
+                sprite.durations.assign(sprite.frameCount, option.frameMs > 0 ? option.frameMs : sprite.durations[0]);
+            }
+        }
+        else
+        {
+            sprite.image = LoadImage(file.string().c_str());
+            if (sprite.image.data == nullptr)
+            {
+                fprintf(stderr, "could not load %s\n", file.string().c_str());
+                return 1;
+            }
+            ImageFormat(&sprite.image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            sprite.frameCount = std::max(option.frames, 1);
+            sprite.durations.assign(sprite.frameCount, option.frameMs > 0 ? option.frameMs : defaultFrameMs);
+        }
+        int frameWidth = sprite.image.width / sprite.frameCount;
+        for (int f = 0; f < sprite.frameCount; f++)
+        {
+            frames.push_back({static_cast<int>(sprites.size()), f, frameWidth, sprite.image.height});
+        }
+        sprites.push_back(std::move(sprite));
+    }
+    for (const auto &[file, option] : options)
+    {
+        if (!option.seen)
+        {
+            fprintf(stderr, "%s is named on the command line but it is not in %s\n", file.c_str(), artDir.string().c_str());
+            return 1;
+        }
+    }
+
+    // [-------------- PACK -----------------------]
+    // Tallest first. The smallest power of two page that takes everything,
+    // past the largest size the leftovers spill onto more pages
+    std::vector<Frame *> pending;
+    for (Frame &frame : frames)
+    {
+        if (frame.width + 2 * padding > maxPageSize || frame.height + 2 * padding > maxPageSize)
+        {
+            fprintf(stderr, "%s is bigger than a %d page\n", sprites[frame.sprite].file.c_str(), maxPageSize);
+            return 1;
+        }
+        pending.push_back(&frame);
+    }
+
+    std::vector<int> pageSizes;
+    while (!pending.empty())
+    {
+        std::stable_sort(pending.begin(), pending.end(), [](const Frame *a, const Frame *b)
+        {
+            return a->height != b->height ? a->height > b->height : a->width > b->width;
+        });
+        int page = static_cast<int>(pageSizes.size());
+        int size = minPageSize;
+        while (size < maxPageSize && !packPage(pending, size, page))
+        {
+            size *= 2;
+        }
+        if (size == maxPageSize)
+        {
+            // Fill this page greedily a sprite at a time, so all of a sprite's
+            // frames share a page. What does not fit goes on the next one
+            Skyline skyline(size);
+            std::vector<Frame *> leftover;
+            for (int s = 0; s < static_cast<int>(sprites.size()); s++)
+            {
+                Skyline attempt = skyline;
+                std::vector<Frame *> placed;
+                bool fits = true;
+                for (Frame *frame : pending)
+                {
+                    int x, y;
+                    if (frame->sprite != s)
+                    {
+                        continue;
+                    }
+                    placed.push_back(frame);
+                    if (fits && attempt.insert(frame->width + 2 * padding, frame->height + 2 * padding, x, y))
+                    {
+                        frame->page = page;
+                        frame->x = x + padding;
+                        frame->y = y + padding;
+                    }
+                    else
+                    {
+                        fits = false;
+                    }
+                }
+                if (fits)
+                {
+                    skyline = attempt;
+                }
+                else
+                {
+                    leftover.insert(leftover.end(), placed.begin(), placed.end());
+                }
+            }
+            if (leftover.size() == pending.size())
+            {
+                fprintf(stderr, "%s does not fit on one %d page\n", sprites[leftover.front()->sprite].file.c_str(), maxPageSize);
+                return 1;
+            }
+            pending = std::move(leftover);
+        }
+        else
+        {
+            pending.clear();
+        }
+        pageSizes.push_back(size);
+    }
+
+    // [-------------- WRITE PAGES -----------------------]
+    std::filesystem::create_directories(pageDir);
+    std::vector<std::string> pagePaths;
+    AssetPackWriter pack;
+    for (int page = 0; page < static_cast<int>(pageSizes.size()); page++)
+    {
+        int size = pageSizes[page];
+        Image atlas = GenImageColor(size, size, BLANK);
+        auto *target = static_cast<unsigned char *>(atlas.data);
+        for (const Frame &frame : frames)
+        {
+            if (frame.page != page)
+            {
+                continue;
+            }
+            const Image &source = sprites[frame.sprite].image;
+            const auto *pixels = static_cast<const unsigned char *>(source.data);
+            for (int row = 0; row < frame.height; row++)
+            {
+                memcpy(target + (static_cast<size_t>(frame.y + row) * size + frame.x) * 4,
+                       pixels + (static_cast<size_t>(row) * source.width + frame.index * frame.width) * 4,
+                       static_cast<size_t>(frame.width) * 4);
+            }
+        }
+        std::string path = (pageDir / ("atlas_" + std::to_string(page) + ".png")).generic_string();
+        if (!ExportImage(atlas, path.c_str()))
+        {
+            fprintf(stderr, "could not write %s\n", path.c_str());
+            return 1;
+        }
+        // Indexed by the PNG's path, the game falls back to that without a pack
+        if (!pack.add(path, atlas.data, static_cast<size_t>(size) * size * 4, size, size, atlas.format))
+        {
+            fprintf(stderr, "page path %s is too long for the pack index\n", path.c_str());
+            return 1;
+        }
+        UnloadImage(atlas);
+        pagePaths.push_back(path);
+    }
+
+    // [-------------- WRITE PACK -----------------------]
+    std::string packPath = (pageDir / "atlas.pack").generic_string();
+    AssetPack check;
+    bool packOk = pack.write(packPath.c_str()) && check.open(packPath.c_str()) && check.entryCount() == static_cast<int>(pagePaths.size());
+    for (int page = 0; packOk && page < check.entryCount(); page++)
+    {
+        packOk = check.find(pagePaths[page].c_str()) == page && check.verify(page);
+    }
+    if (!packOk)
+    {
+        fprintf(stderr, "could not write %s\n", packPath.c_str());
+        return 1;
+    }
+
+    // [-------------- WRITE HEADER -----------------------]
+    FILE *header = fopen(headerPath, "w");
+    if (header == nullptr)
+    {
+        fprintf(stderr, "could not write %s\n", headerPath);
+        return 1;
+    }
+    fprintf(header, "/**\n * Generated by GGJ24AtlasPacker from %s - do not edit.\n*/\n\n", artDir.generic_string().c_str());
+    fprintf(header, "#ifndef GGJ24_ATLAS_FRAMES_H\n#define GGJ24_ATLAS_FRAMES_H\n\n#include \"raylib.h\"\n#include \"sprite_sheet.h\"\n\n");
+
+    // The sim animates from sprite_sheet.h, which can't see the art - any
+    // difference to what was packed stops the front end compiling
+    fprintf(header, "// The art as packed must be what sprite_sheet.h says it is\n");
+    fprintf(header, "static_assert(SPRITE_COUNT == %d && spriteFrameCount == %d, \"sprite_sheet.h doesn't list the sprites that were packed\");\n",
+            static_cast<int>(sprites.size()), static_cast<int>(frames.size()));
+    int first = 0;
+    for (size_t i = 0; i < sprites.size(); i++)
+    {
+        const SourceSprite &sprite = sprites[i];
+        const char *name = sprite.name.c_str();
+        fprintf(header, "static_assert(%s == %d && spriteFrames[%s].first == %d && spriteFrames[%s].count == %d,\n"
+                        "              \"%s's frames in sprite_sheet.h don't match %s\");\n",
+                name, static_cast<int>(i), name, first, name, sprite.frameCount, name, sprite.file.c_str());
+        fprintf(header, "static_assert(");
+        for (int f = 0; f < sprite.frameCount; f++)
+        {
+            fprintf(header, "%sspriteFrameDurations[%d] == %d", f == 0 ? "" : " && ", first + f, sprite.durations[f]);
+        }
+        fprintf(header, ",\n              \"%s's frame durations in sprite_sheet.h don't match %s\");\n", name, sprite.file.c_str());
+        first += sprite.frameCount;
+    }
+    fprintf(header, "\n");
+
+    fprintf(header, "struct AtlasPage\n{\n    const char *path;\n    int width;\n    int height;\n};\n\n");
+    fprintf(header, "// A named frame range from an Aseprite file, direction as Aseprite stores it\n");
+    fprintf(header, "struct AtlasTag\n{\n    AtlasSprite sprite;\n    const char *name;\n    int from;\n    int to;\n    int direction;\n};\n\n");
+
+    fprintf(header, "constexpr int atlasPageCount{%d};\n", static_cast<int>(pageSizes.size()));
+    fprintf(header, "constexpr AtlasPage atlasPages[atlasPageCount] = {\n");
+    for (size_t page = 0; page < pageSizes.size(); page++)
+    {
+        fprintf(header, "    {\"%s\", %d, %d},\n", pagePaths[page].c_str(), pageSizes[page], pageSizes[page]);
+    }
+    fprintf(header, "};\n");
+    fprintf(header, "// The same pages pre-decoded, see asset_pack.h\n");
+    fprintf(header, "constexpr const char *atlasPackPath{\"%s\"};\n\n", packPath.c_str());
+
+    fprintf(header, "// Where each of sprite_sheet.h's frames is on its sprite's page\n");
+    fprintf(header, "constexpr Rectangle atlasFrames[spriteFrameCount] = {\n");
+    for (const Frame &frame : frames)
+    {
+        fprintf(header, "    {%d.f, %d.f, %d.f, %d.f},    // %s %d\n", frame.x, frame.y, frame.width, frame.height,
+                sprites[frame.sprite].name.c_str(), frame.index);
+    }
+    fprintf(header, "};\n\n");
+
+    // A sprite never straddles pages
+    fprintf(header, "constexpr int atlasSpritePages[SPRITE_COUNT] = {\n");
+    for (size_t i = 0; i < sprites.size(); i++)
+    {
+        int page = 0;
+        for (const Frame &frame : frames)
+        {
+            if (frame.sprite == static_cast<int>(i))
+            {
+                page = frame.page;
+            }
+        }
+        fprintf(header, "    %d,    // %s\n", page, sprites[i].name.c_str());
+    }
+    fprintf(header, "};\n\n");
+
+    // Never empty, a zero length array is not C++
+    int tagCount = 0;
+    for (const SourceSprite &sprite : sprites)
+    {
+        tagCount += static_cast<int>(sprite.tags.size());
+    }
+    fprintf(header, "constexpr int atlasTagCount{%d};\n", tagCount);
+    fprintf(header, "constexpr AtlasTag atlasTags[%d] = {\n", std::max(tagCount, 1));
+    for (const SourceSprite &sprite : sprites)
+    {
+        for (const AseTag &tag : sprite.tags)
+        {
+            std::string name;
+            for (char c : tag.name)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    name += '\\';
+                }
+                name += c;
+            }
+            fprintf(header, "    {%s, \"%s\", %d, %d, %d},\n", sprite.name.c_str(), name.c_str(), tag.from, tag.to, tag.direction);
+        }
+    }
+    if (tagCount == 0)
+    {
+        fprintf(header, "    {SPRITE_COUNT, \"\", 0, 0, 0},\n");
+    }
+    fprintf(header, "};\n\n#endif //GGJ24_ATLAS_FRAMES_H\n");
+    fclose(header);
+
+    for (SourceSprite &sprite : sprites)
+    {
+        UnloadImage(sprite.image);
+    }
+    printf("packed %d frames from %d images into %d page(s)\n", static_cast<int>(frames.size()),
+           static_cast<int>(sprites.size()), static_cast<int>(pageSizes.size()));
+    return 0;
+}
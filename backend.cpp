@@ -0,0 +1,165 @@
+#include "backend.h"
+
+#include "triple_buffer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Longest frame we try to catch up on, stops a stall turning into a tick spiral
+constexpr double maxFrameSeconds{0.25};
+
+// Held keys take the latest state, presses and mouse motion pile up until a tick consumes them
+static void mergeInputs(SimInputs &pending, const SimInputs &latest)
+{
+    pending.moveForward = latest.moveForward;
+    pending.moveBack = latest.moveBack;
+    pending.moveLeft = latest.moveLeft;
+    pending.moveRight = latest.moveRight;
+    pending.sprint = latest.sprint;
+    pending.crouch = latest.crouch;
+    pending.crouchReleased |= latest.crouchReleased;
+    pending.jump |= latest.jump;
+    pending.fire |= latest.fire;
+    pending.start |= latest.start;
+    pending.restart |= latest.restart;
+    pending.anyKeyPressed |= latest.anyKeyPressed;
+    pending.mouseDelta.x += latest.mouseDelta.x;
+    pending.mouseDelta.y += latest.mouseDelta.y;
+}
+
+static void consumeEdges(SimInputs &pending)
+{
+    pending.crouchReleased = false;
+    pending.jump = false;
+    pending.fire = false;
+    pending.start = false;
+    pending.restart = false;
+    pending.anyKeyPressed = false;
+    pending.mouseDelta = {0.f, 0.f};
+}
+
+void runSimLoop(Sim &sim, Backend &backend, ReplayWriter *recording)
+{
+    const double tickSeconds{sim.tickSeconds()};
+    double accumulator{0.0};
+    SimInputs pending;
+    SimSnapshot snapshot;
+    snapshot.capture(sim);
+
+    while (!backend.shouldClose())
+    {
+        double frameSeconds = backend.frameTime();
+        if (frameSeconds > maxFrameSeconds)
+        {
+            frameSeconds = maxFrameSeconds;
+        }
+        accumulator += frameSeconds;
+        mergeInputs(pending, backend.pollInputs(snapshot));
+
+        while (accumulator >= tickSeconds)
+        {
+            if (recording != nullptr)
+            {
+                recording->record(pending);
+            }
+            sim.step(pending, static_cast<float>(tickSeconds));
+            consumeEdges(pending);
+            accumulator -= tickSeconds;
+        }
+
+        snapshot.capture(sim);
+        backend.present(snapshot, static_cast<float>(accumulator / tickSeconds));
+    }
+
+    if (recording != nullptr)
+    {
+        recording->finish(sim.checksum());
+    }
+}
+
+void runPipelinedSimLoop(Sim &sim, Backend &backend, ReplayWriter *recording)
+{
+    const double tickSeconds{sim.tickSeconds()};
+    TripleBuffer<SimSnapshot> snapshots;
+    snapshots.back().capture(sim);
+    snapshots.publish();
+
+    // Frame time and inputs the render thread has handed over and the sim
+    // thread has yet to take, piling up if the sim falls behind
+    std::mutex postMutex;
+    std::condition_variable posted;
+    std::condition_variable taken;
+    SimInputs postedInputs;
+    double postedSeconds{0.0};
+    bool closing{false};
+
+    std::thread simThread([&]
+    {
+        double accumulator{0.0};
+        SimInputs pending;
+        while (true)
+        {
+            {
+                std::unique_lock lock(postMutex);
+                posted.wait(lock, [&] { return closing || postedSeconds > 0.0; });
+                if (closing)
+                {
+                    return;
+                }
+                accumulator += std::min(postedSeconds, maxFrameSeconds);
+                mergeInputs(pending, postedInputs);
+                consumeEdges(postedInputs);
+                postedSeconds = 0.0;
+            }
+            taken.notify_one();
+
+            while (accumulator >= tickSeconds)
+            {
+                if (recording != nullptr)
+                {
+                    recording->record(pending);
+                }
+                sim.step(pending, static_cast<float>(tickSeconds));
+                consumeEdges(pending);
+                accumulator -= tickSeconds;
+            }
+
+            SimSnapshot &snapshot = snapshots.back();
+            snapshot.capture(sim);
+            snapshot.alpha = static_cast<float>(accumulator / tickSeconds);
+            snapshots.publish();
+        }
+    });
+
+    while (!backend.shouldClose())
+    {
+        double frameSeconds = backend.frameTime();
+        // The newest ticks the sim has finished, the one after is already underway
+        const SimSnapshot &snapshot = snapshots.front();
+        SimInputs latest = backend.pollInputs(snapshot);
+        {
+            // No further ahead of the sim than it would catch up on, past that
+            // the time would only be dropped
+            std::unique_lock lock(postMutex);
+            taken.wait(lock, [&] { return postedSeconds < maxFrameSeconds; });
+            postedSeconds += frameSeconds;
+            mergeInputs(postedInputs, latest);
+        }
+        posted.notify_one();
+        backend.present(snapshot, snapshot.alpha);
+    }
+
+    {
+        std::lock_guard lock(postMutex);
+        closing = true;
+    }
+    posted.notify_one();
+    simThread.join();
+
+    if (recording != nullptr)
+    {
+        recording->finish(sim.checksum());
+    }
+}
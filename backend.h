@@ -0,0 +1,37 @@
+/**
+ * Front end interface for the sim.
+ * A backend supplies frame time and inputs and presents the sim state.
+ * RaylibBackend is the real game window, NullBackend drives the sim headless.
+*/
+
+#ifndef GGJ24_BACKEND_H
+#define GGJ24_BACKEND_H
+
+#include "sim.h"
+#include "replay.h"
+#include "sim_snapshot.h"
+
+class Backend
+{
+public:
+    virtual ~Backend() = default;
+
+    virtual bool shouldClose() = 0;
+    virtual float frameTime() = 0;
+    // snapshot is the frame on screen, inputs are the player's reaction to it
+    virtual SimInputs pollInputs(const SimSnapshot &snapshot) = 0;
+    // alpha blends between the snapshot's last two ticks, see SimSnapshot::view()
+    virtual void present(const SimSnapshot &snapshot, float alpha) = 0;
+};
+
+// Main loop shared by every front end. Renders once per backend frame and
+// steps the sim at its own fixed tick rate with an accumulator. With a
+// recording, every tick's inputs go to it and it is finished on the way out
+void runSimLoop(Sim &sim, Backend &backend, ReplayWriter *recording = nullptr);
+// Same, with the sim on a thread of its own: it works on the next ticks
+// while this thread draws the last ones, handed over through a triple
+// buffer of snapshots. A frame costs the slower of the two rather than both.
+// Inputs reach the sim a frame later than with runSimLoop()
+void runPipelinedSimLoop(Sim &sim, Backend &backend, ReplayWriter *recording = nullptr);
+
+#endif //GGJ24_BACKEND_H
@@ -0,0 +1,193 @@
+#include "ecs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+int nextComponentId()
+{
+    static std::atomic<int> next{0};
+    int id = next++;
+    if (id >= maxComponentTypes)
+    {
+        fprintf(stderr, "ECS: more than %d component types\n", maxComponentTypes);
+        abort();
+    }
+    return id;
+}
+
+// [-------------- ARCHETYPE -----------------------]
+
+int Archetype::columnOf(int component) const
+{
+    if ((mask & (ComponentMask{1} << component)) == 0)
+    {
+        return -1;
+    }
+    // Few columns, a scan beats a map
+    for (int c = 0; c < static_cast<int>(columns.size()); c++)
+    {
+        if (columns[c].component == component)
+        {
+            return c;
+        }
+    }
+    return -1;
+}
+
+int Archetype::push(Entity entity)
+{
+    int row = size();
+    entities.push_back(entity);
+    for (Column &column : columns)
+    {
+        column.data.resize(column.data.size() + column.size, 0);
+    }
+    return row;
+}
+
+Entity Archetype::erase(int row)
+{
+    int last = size() - 1;
+    Entity moved{};
+    if (row != last)
+    {
+        moved = entities[last];
+        entities[row] = moved;
+        for (int c = 0; c < static_cast<int>(columns.size()); c++)
+        {
+            memcpy(at(c, row), at(c, last), columns[c].size);
+        }
+    }
+    entities.pop_back();
+    for (Column &column : columns)
+    {
+        column.data.resize(column.data.size() - column.size);
+    }
+    return moved;
+}
+
+// [-------------- WORLD -----------------------]
+
+Entity World::allocate()
+{
+    living++;
+    if (freeHead >= 0)
+    {
+        int index = freeHead;
+        freeHead = slots[index].row;
+        return {static_cast<uint32_t>(index), slots[index].generation};
+    }
+    slots.emplace_back();
+    return {static_cast<uint32_t>(slots.size() - 1), 0};
+}
+
+const World::Slot *World::slotOf(Entity entity) const
+{
+    if (entity.index >= slots.size())
+    {
+        return nullptr;
+    }
+    const Slot &slot = slots[entity.index];
+    return slot.generation == entity.generation && slot.archetype >= 0 ? &slot : nullptr;
+}
+
+bool World::alive(Entity entity) const
+{
+    return slotOf(entity) != nullptr;
+}
+
+int World::archetypeFor(ComponentMask mask, const std::vector<ColumnType> &types)
+{
+    for (int a = 0; a < static_cast<int>(archetypes.size()); a++)
+    {
+        if (archetypes[a].mask == mask)
+        {
+            return a;
+        }
+    }
+    Archetype archetype;
+    archetype.mask = mask;
+    for (const ColumnType &type : types)
+    {
+        archetype.columns.push_back({type.component, type.size, {}});
+    }
+    std::sort(archetype.columns.begin(), archetype.columns.end(), [](const Archetype::Column &a, const Archetype::Column &b)
+    {
+        return a.component < b.component;
+    });
+    archetypes.push_back(std::move(archetype));
+    return static_cast<int>(archetypes.size()) - 1;
+}
+
+void World::place(Entity entity, int archetype)
+{
+    Slot &slot = slots[entity.index];
+    slot.archetype = archetype;
+    slot.row = archetypes[archetype].push(entity);
+}
+
+void World::move(Entity entity, int archetype)
+{
+    Slot &slot = slots[entity.index];
+    Archetype &from = archetypes[slot.archetype];
+    Archetype &to = archetypes[archetype];
+    int fromRow = slot.row;
+    int toRow = to.push(entity);
+    for (int c = 0; c < static_cast<int>(from.columns.size()); c++)
+    {
+        int target = to.columnOf(from.columns[c].component);
+        if (target >= 0)
+        {
+            memcpy(to.at(target, toRow), from.at(c, fromRow), from.columns[c].size);
+        }
+    }
+    Entity moved = from.erase(fromRow);
+    if (moved.index != ~0u)
+    {
+        slots[moved.index].row = fromRow;
+    }
+    slot.archetype = archetype;
+    slot.row = toRow;
+}
+
+void World::destroy(Entity entity)
+{
+    if (slotOf(entity) == nullptr)
+    {
+        return;
+    }
+    Slot &slot = slots[entity.index];
+    Entity moved = archetypes[slot.archetype].erase(slot.row);
+    if (moved.index != ~0u)
+    {
+        slots[moved.index].row = slot.row;
+    }
+    slot.generation++;
+    slot.archetype = -1;
+    slot.row = freeHead;
+    freeHead = static_cast<int>(entity.index);
+    living--;
+}
+
+void World::clear()
+{
+    for (Archetype &archetype : archetypes)
+    {
+        for (Entity entity : archetype.entities)
+        {
+            Slot &slot = slots[entity.index];
+            slot.generation++;
+            slot.archetype = -1;
+            slot.row = freeHead;
+            freeHead = static_cast<int>(entity.index);
+        }
+        archetype.entities.clear();
+        for (Archetype::Column &column : archetype.columns)
+        {
+            column.data.clear();
+        }
+    }
+    living = 0;
+}
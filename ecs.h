@@ -0,0 +1,267 @@
+/**
+ * Archetype entity component system. Entities with the same set of
+ * components share an archetype, which keeps each component in its own
+ * packed column - systems walk whole columns for every archetype holding
+ * the components they ask for, never a scattered entity at a time.
+ * Entities are handles of an index and a generation; destroying one bumps
+ * the generation, so old handles to a reused slot read as dead instead of
+ * as whoever lives there now. Components are plain data (trivially
+ * copyable) and moved with memcpy when an entity changes archetype.
+*/
+
+#ifndef GGJ24_ECS_H
+#define GGJ24_ECS_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+struct Entity
+{
+    uint32_t index{~0u};
+    uint32_t generation{0};
+
+    bool operator==(const Entity &other) const { return index == other.index && generation == other.generation; }
+};
+
+// One bit per component type, so at most 64 of them
+using ComponentMask = uint64_t;
+constexpr int maxComponentTypes{64};
+
+int nextComponentId();
+
+// Dense id of component type T, handed out on first use
+template<typename T>
+int componentId()
+{
+    static const int id = nextComponentId();
+    return id;
+}
+
+template<typename... Ts>
+ComponentMask componentMask()
+{
+    return ((ComponentMask{1} << componentId<Ts>()) | ... | ComponentMask{0});
+}
+
+class Archetype
+{
+public:
+    ComponentMask mask{0};
+    // Row r of every column belongs to entities[r]
+    std::vector<Entity> entities;
+
+    int size() const { return static_cast<int>(entities.size()); }
+
+    // T's column, null if this archetype has no T
+    template<typename T>
+    T *column()
+    {
+        int c = columnOf(componentId<T>());
+        return c < 0 ? nullptr : reinterpret_cast<T *>(columns[c].data.data());
+    }
+
+private:
+    friend class World;
+
+    struct Column
+    {
+        int component;
+        size_t size;
+        std::vector<unsigned char> data;
+    };
+
+    int columnOf(int component) const;
+    unsigned char *at(int column, int row) { return columns[column].data.data() + columns[column].size * row; }
+    // Appends a row for entity, components left zeroed
+    int push(Entity entity);
+    // Swap-removes row, returns the entity moved into it (or an invalid one)
+    Entity erase(int row);
+
+    // Sorted by component id
+    std::vector<Column> columns;
+};
+
+class World
+{
+public:
+    // A new entity with exactly these components
+    template<typename... Ts>
+    Entity create(const Ts &...components);
+    void destroy(Entity entity);
+    bool alive(Entity entity) const;
+    // Drops every entity, handles from before all read as dead
+    void clear();
+
+    // entity's T, null if it is dead or has none. Good until entities are
+    // created, destroyed or change components
+    template<typename T>
+    T *get(Entity entity);
+    template<typename T>
+    const T *get(Entity entity) const { return const_cast<World *>(this)->get<T>(entity); }
+    template<typename T>
+    bool has(Entity entity) const { return get<T>(entity) != nullptr; }
+
+    // Moves entity to the archetype with (or without) T as well
+    template<typename T>
+    void add(Entity entity, const T &component);
+    template<typename T>
+    void remove(Entity entity);
+
+    // fn(count, entities, Ts *...) once per archetype holding all of Ts, the
+    // pointers being its packed columns. Don't create or destroy inside
+    template<typename... Ts, typename F>
+    void eachChunk(F &&fn);
+    // fn(entity, Ts &...) for every entity holding all of Ts
+    template<typename... Ts, typename F>
+    void each(F &&fn);
+    // Read-only versions, fn gets const columns
+    template<typename... Ts, typename F>
+    void eachChunk(F &&fn) const;
+    template<typename... Ts, typename F>
+    void each(F &&fn) const;
+
+    int entityCount() const { return living; }
+    int archetypeCount() const { return static_cast<int>(archetypes.size()); }
+
+private:
+    struct Slot
+    {
+        uint32_t generation{0};
+        int archetype{-1};
+        int row{-1};                // next free slot while free
+    };
+
+    struct ColumnType
+    {
+        int component;
+        size_t size;
+    };
+
+    Entity allocate();
+    // Archetype with exactly these columns, made if it does not exist
+    int archetypeFor(ComponentMask mask, const std::vector<ColumnType> &types);
+    void place(Entity entity, int archetype);
+    // Moves entity's row to archetype, copying the components both share
+    void move(Entity entity, int archetype);
+    const Slot *slotOf(Entity entity) const;
+
+    std::vector<Slot> slots;
+    int freeHead{-1};
+    int living{0};
+    std::vector<Archetype> archetypes;
+};
+
+// [-------------- TEMPLATES -----------------------]
+
+template<typename... Ts>
+Entity World::create(const Ts &...components)
+{
+    static_assert((std::is_trivially_copyable_v<Ts> && ...), "components are moved with memcpy");
+    Entity entity = allocate();
+    int archetype = archetypeFor(componentMask<Ts...>(), {ColumnType{componentId<Ts>(), sizeof(Ts)}...});
+    place(entity, archetype);
+    (memcpy(get<Ts>(entity), &components, sizeof(Ts)), ...);
+    return entity;
+}
+
+template<typename T>
+T *World::get(Entity entity)
+{
+    const Slot *slot = slotOf(entity);
+    if (slot == nullptr)
+    {
+        return nullptr;
+    }
+    T *column = archetypes[slot->archetype].column<T>();
+    return column == nullptr ? nullptr : column + slot->row;
+}
+
+template<typename T>
+void World::add(Entity entity, const T &component)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "components are moved with memcpy");
+    const Slot *slot = slotOf(entity);
+    if (slot == nullptr)
+    {
+        return;
+    }
+    const Archetype &from = archetypes[slot->archetype];
+    if ((from.mask & componentMask<T>()) == 0)
+    {
+        std::vector<ColumnType> types;
+        for (const Archetype::Column &column : from.columns)
+        {
+            types.push_back({column.component, column.size});
+        }
+        types.push_back({componentId<T>(), sizeof(T)});
+        move(entity, archetypeFor(from.mask | componentMask<T>(), types));
+    }
+    memcpy(get<T>(entity), &component, sizeof(T));
+}
+
+template<typename T>
+void World::remove(Entity entity)
+{
+    const Slot *slot = slotOf(entity);
+    if (slot == nullptr || (archetypes[slot->archetype].mask & componentMask<T>()) == 0)
+    {
+        return;
+    }
+    const Archetype &from = archetypes[slot->archetype];
+    std::vector<ColumnType> types;
+    for (const Archetype::Column &column : from.columns)
+    {
+        if (column.component != componentId<T>())
+        {
+            types.push_back({column.component, column.size});
+        }
+    }
+    move(entity, archetypeFor(from.mask & ~componentMask<T>(), types));
+}
+
+template<typename... Ts, typename F>
+void World::eachChunk(F &&fn)
+{
+    ComponentMask wanted = componentMask<Ts...>();
+    for (Archetype &archetype : archetypes)
+    {
+        if ((archetype.mask & wanted) == wanted && archetype.size() > 0)
+        {
+            fn(archetype.size(), archetype.entities.data(), archetype.column<Ts>()...);
+        }
+    }
+}
+
+template<typename... Ts, typename F>
+void World::each(F &&fn)
+{
+    eachChunk<Ts...>([&](int count, const Entity *entities, Ts *...columns)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            fn(entities[i], columns[i]...);
+        }
+    });
+}
+
+template<typename... Ts, typename F>
+void World::eachChunk(F &&fn) const
+{
+    const_cast<World *>(this)->eachChunk<Ts...>([&](int count, const Entity *entities, Ts *...columns)
+    {
+        fn(count, entities, static_cast<const Ts *>(columns)...);
+    });
+}
+
+template<typename... Ts, typename F>
+void World::each(F &&fn) const
+{
+    const_cast<World *>(this)->each<Ts...>([&](Entity entity, Ts &...components)
+    {
+        fn(entity, static_cast<const Ts &>(components)...);
+    });
+}
+
+#endif //GGJ24_ECS_H
@@ -0,0 +1,167 @@
+#include "frustum_cull.h"
+
+#include "raymath.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GGJ24_SIMD_X86 1
+#endif
+
+// raylib's RL_CULL_DISTANCE_NEAR / RL_CULL_DISTANCE_FAR, what BeginMode3D() projects with
+constexpr float nearDistance{0.01f};
+constexpr float farDistance{1000.f};
+
+void FrustumCuller::begin(const Camera &camera, float aspect)
+{
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+    float tanV = tanf(camera.fovy * DEG2RAD * 0.5f);
+    float tanH = tanV * aspect;
+
+    // Each side plane holds the eye and one frustum edge, normals point inwards
+    Vector3 normals[6] = {
+        forward,                                                        // near
+        Vector3Negate(forward),                                         // far
+        Vector3Normalize(Vector3Add(right, Vector3Scale(forward, tanH))),                   // left
+        Vector3Normalize(Vector3Add(Vector3Negate(right), Vector3Scale(forward, tanH))),    // right
+        Vector3Normalize(Vector3Add(up, Vector3Scale(forward, tanV))),                      // bottom
+        Vector3Normalize(Vector3Add(Vector3Negate(up), Vector3Scale(forward, tanV)))        // top
+    };
+    Vector3 points[6] = {
+        Vector3Add(camera.position, Vector3Scale(forward, nearDistance)),
+        Vector3Add(camera.position, Vector3Scale(forward, farDistance)),
+        camera.position, camera.position, camera.position, camera.position
+    };
+    for (int p = 0; p < 6; p++)
+    {
+        nx[p] = normals[p].x;
+        ny[p] = normals[p].y;
+        nz[p] = normals[p].z;
+        d[p] = -Vector3DotProduct(normals[p], points[p]);
+    }
+    frameStats = {};
+}
+
+void FrustumCuller::reserve(int size)
+{
+    if (x.size() < static_cast<size_t>(size))
+    {
+        for (auto *column : {&x, &y, &z, &ex, &ey, &ez})
+        {
+            column->resize(size);
+        }
+        visible.resize(size);
+    }
+}
+
+void FrustumCuller::count(int tested, int passed)
+{
+    frameStats.visible += passed;
+    frameStats.culled += tested - passed;
+}
+
+// [-------------- BATCH KERNELS -----------------------]
+// Both tests are "signed distance to every plane, pushed out by the bound's
+// reach, is >= 0". Spheres reach r along any normal, boxes |n| . extents.
+
+int FrustumCuller::cullSpheres(const float *sx, const float *sy, const float *sz, float radius, int total, int *out)
+{
+    int passed = 0;
+    int i = 0;
+#ifdef GGJ24_SIMD_X86
+    const __m128 reach = _mm_set1_ps(radius);
+    for (; i + 4 <= total; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(sx + i), py = _mm_loadu_ps(sy + i), pz = _mm_loadu_ps(sz + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(nx[p])), _mm_mul_ps(py, _mm_set1_ps(ny[p]))),
+                                         _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(nz[p])), _mm_set1_ps(d[p])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(inside);
+        while (mask)
+        {
+            out[passed++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < total; i++)
+    {
+        if (sphereInside({sx[i], sy[i], sz[i]}, radius))
+        {
+            out[passed++] = i;
+        }
+    }
+    count(total, passed);
+    return passed;
+}
+
+int FrustumCuller::cullBoxes(const float *cx, const float *cy, const float *cz,
+                             const float *bx, const float *by, const float *bz, int total, int *out)
+{
+    int passed = 0;
+    int i = 0;
+#ifdef GGJ24_SIMD_X86
+    for (; i + 4 <= total; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(cx + i), py = _mm_loadu_ps(cy + i), pz = _mm_loadu_ps(cz + i);
+        __m128 hx = _mm_loadu_ps(bx + i), hy = _mm_loadu_ps(by + i), hz = _mm_loadu_ps(bz + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(nx[p])), _mm_mul_ps(py, _mm_set1_ps(ny[p]))),
+                                         _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(nz[p])), _mm_set1_ps(d[p])));
+            __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(hx, _mm_set1_ps(fabsf(nx[p]))), _mm_mul_ps(hy, _mm_set1_ps(fabsf(ny[p])))),
+                                      _mm_mul_ps(hz, _mm_set1_ps(fabsf(nz[p]))));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(inside);
+        while (mask)
+        {
+            out[passed++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < total; i++)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; p++)
+        {
+            float distance = nx[p] * cx[i] + ny[p] * cy[i] + nz[p] * cz[i] + d[p];
+            float reach = fabsf(nx[p]) * bx[i] + fabsf(ny[p]) * by[i] + fabsf(nz[p]) * bz[i];
+            inside = distance + reach >= 0.f;
+        }
+        if (inside)
+        {
+            out[passed++] = i;
+        }
+    }
+    count(total, passed);
+    return passed;
+}
+
+bool FrustumCuller::sphereVisible(Vector3 centre, float radius)
+{
+    bool inside = sphereInside(centre, radius);
+    count(1, inside ? 1 : 0);
+    return inside;
+}
+
+bool FrustumCuller::sphereInside(Vector3 centre, float radius) const
+{
+    for (int p = 0; p < 6; p++)
+    {
+        if (nx[p] * centre.x + ny[p] * centre.y + nz[p] * centre.z + d[p] + radius < 0.f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
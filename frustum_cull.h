@@ -0,0 +1,57 @@
+/**
+ * CPU view frustum culling. The six planes come straight from a raylib
+ * Camera (position, target, up, fovy) and the screen aspect, using raylib's
+ * own near and far distances. Bounds are tested in SSE batches of four -
+ * spheres for projectiles and billboards, AABBs for columns - and the
+ * culler keeps visible / culled counts for the debug overlay.
+*/
+
+#ifndef GGJ24_FRUSTUM_CULL_H
+#define GGJ24_FRUSTUM_CULL_H
+
+#include "raylib.h"
+
+#include <vector>
+
+struct CullStats
+{
+    int visible{0};
+    int culled{0};
+};
+
+class FrustumCuller
+{
+public:
+    // Planes for this frame's camera, resets the counters
+    void begin(const Camera &camera, float aspect);
+
+    // [-------------- BATCHED -----------------------]
+    // Tests count spheres (centres in SoA, one shared radius) and writes the
+    // index of each one at least partly inside to visible, returns how many
+    int cullSpheres(const float *x, const float *y, const float *z, float radius, int count, int *visible);
+    // Same for count AABBs given as centres and half extents
+    int cullBoxes(const float *cx, const float *cy, const float *cz,
+                  const float *ex, const float *ey, const float *ez, int count, int *visible);
+
+    // [-------------- SINGLE -----------------------]
+    bool sphereVisible(Vector3 centre, float radius);
+
+    CullStats stats() const { return frameStats; }
+
+    // Scratch the caller can fill with positions / bounds before a batched
+    // call, reserve() grows it to at least size entries
+    std::vector<float> x, y, z;
+    std::vector<float> ex, ey, ez;
+    std::vector<int> visible;
+    void reserve(int size);
+
+private:
+    void count(int tested, int passed);
+    bool sphereInside(Vector3 centre, float radius) const;
+
+    // Inward facing planes n.p + d >= 0, SoA so a batch tests one plane at a time
+    float nx[6]{}, ny[6]{}, nz[6]{}, d[6]{};
+    CullStats frameStats;
+};
+
+#endif //GGJ24_FRUSTUM_CULL_H
@@ -0,0 +1,443 @@
+#include "gif_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Browsers play delays this short at 10 FPS, GIFs are authored for that
+constexpr int minDelayCs{2};
+constexpr int shortDelayMs{100};
+// LZW codes are at most 12 bits
+constexpr int maxCodes{4096};
+
+GifDecoder::~GifDecoder()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+}
+
+bool GifDecoder::fail(const char *message)
+{
+    lastError = message;
+    return false;
+}
+
+bool GifDecoder::open(const char *path)
+{
+    file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return fail("can't open file");
+    }
+    unsigned char header[13];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        return fail("truncated header");
+    }
+    if (memcmp(header, "GIF87a", 6) != 0 && memcmp(header, "GIF89a", 6) != 0)
+    {
+        return fail("not a GIF");
+    }
+    canvasWidth = header[6] | (header[7] << 8);
+    canvasHeight = header[8] | (header[9] << 8);
+    if (canvasWidth == 0 || canvasHeight == 0)
+    {
+        return fail("empty canvas");
+    }
+    if ((header[10] & 0x80) != 0)
+    {
+        globalPaletteSize = 2 << (header[10] & 7);
+        if (!readPalette(globalPalette, globalPaletteSize))
+        {
+            return false;
+        }
+    }
+    firstBlock = ftell(file);
+    canvas.assign(static_cast<size_t>(canvasWidth) * canvasHeight * 4, 0);
+    return true;
+}
+
+bool GifDecoder::rewind()
+{
+    if (file == nullptr || fseek(file, firstBlock, SEEK_SET) != 0)
+    {
+        return fail("can't rewind");
+    }
+    std::fill(canvas.begin(), canvas.end(), 0);
+    frames = 0;
+    delayCs = 0;
+    disposal = 0;
+    transparent = -1;
+    lastDisposal = 0;
+    return true;
+}
+
+bool GifDecoder::readPalette(uint32_t *palette, int size)
+{
+    unsigned char rgb[256 * 3];
+    if (fread(rgb, 3, size, file) != static_cast<size_t>(size))
+    {
+        return fail("truncated palette");
+    }
+    for (int i = 0; i < size; i++)
+    {
+        palette[i] = rgb[3 * i] | (rgb[3 * i + 1] << 8) | (rgb[3 * i + 2] << 16) | 0xFF000000u;
+    }
+    return true;
+}
+
+bool GifDecoder::skipSubBlocks()
+{
+    for (int size = fgetc(file); size != 0; size = fgetc(file))
+    {
+        if (size == EOF || fseek(file, size, SEEK_CUR) != 0)
+        {
+            return fail("truncated extension");
+        }
+    }
+    return true;
+}
+
+bool GifDecoder::readGraphicControl()
+{
+    unsigned char control[6];
+    if (fread(control, 1, sizeof(control), file) != sizeof(control) || control[0] != 4)
+    {
+        return fail("bad graphic control extension");
+    }
+    disposal = (control[1] >> 2) & 7;
+    delayCs = control[2] | (control[3] << 8);
+    transparent = (control[1] & 1) != 0 ? control[4] : -1;
+    // control[5] is the terminator, unless the block is longer than it says
+    return control[5] == 0 || (ungetc(control[5], file) != EOF && skipSubBlocks());
+}
+
+bool GifDecoder::nextFrame(GifFrame &frame)
+{
+    lastError.clear();
+    while (true)
+    {
+        int introducer = fgetc(file);
+        if (introducer == 0x2C)
+        {
+            dispose();
+            if (!readImage())
+            {
+                return false;
+            }
+            frame.rgba = canvas;
+            frame.delayMs = delayCs < minDelayCs ? shortDelayMs : delayCs * 10;
+            delayCs = 0;
+            disposal = 0;
+            transparent = -1;
+            frames++;
+            return true;
+        }
+        if (introducer == 0x21)
+        {
+            int label = fgetc(file);
+            if (label == 0xF9 ? !readGraphicControl() : !skipSubBlocks())
+            {
+                return false;
+            }
+            continue;
+        }
+        // The trailer, or a file cut short after its last whole frame - both end it
+        if (introducer != 0x3B && introducer != EOF)
+        {
+            fail("unknown block");
+        }
+        return false;
+    }
+}
+
+void GifDecoder::dispose()
+{
+    if (lastDisposal == 2)
+    {
+        // Back to transparent rather than the background colour, as browsers do
+        for (int y = lastY; y < lastY + lastHeight; y++)
+        {
+            memset(&canvas[(static_cast<size_t>(y) * canvasWidth + lastX) * 4], 0, static_cast<size_t>(lastWidth) * 4);
+        }
+    }
+    else if (lastDisposal == 3 && !saved.empty())
+    {
+        canvas.swap(saved);
+    }
+    lastDisposal = 0;
+}
+
+int GifDecoder::nextDataByte()
+{
+    if (blockPos == blockSize)
+    {
+        int size = blocksEnded ? 0 : fgetc(file);
+        if (size <= 0 || fread(block, 1, size, file) != static_cast<size_t>(size))
+        {
+            blocksEnded = true;
+            return -1;
+        }
+        blockSize = size;
+        blockPos = 0;
+    }
+    return block[blockPos++];
+}
+
+bool GifDecoder::readImage()
+{
+    unsigned char descriptor[9];
+    if (fread(descriptor, 1, sizeof(descriptor), file) != sizeof(descriptor))
+    {
+        return fail("truncated image descriptor");
+    }
+    int left = descriptor[0] | (descriptor[1] << 8);
+    int top = descriptor[2] | (descriptor[3] << 8);
+    int width = descriptor[4] | (descriptor[5] << 8);
+    int height = descriptor[6] | (descriptor[7] << 8);
+    bool interlaced = (descriptor[8] & 0x40) != 0;
+    const uint32_t *palette = globalPalette;
+    int paletteSize = globalPaletteSize;
+    if ((descriptor[8] & 0x80) != 0)
+    {
+        paletteSize = 2 << (descriptor[8] & 7);
+        if (!readPalette(localPalette, paletteSize))
+        {
+            return false;
+        }
+        palette = localPalette;
+    }
+    int minCodeSize = fgetc(file);
+    if (minCodeSize < 2 || minCodeSize > 11)
+    {
+        return fail("bad LZW code size");
+    }
+
+    // What the next image's disposal has to undo, clipped to the canvas
+    lastDisposal = disposal;
+    lastX = std::min(left, canvasWidth);
+    lastY = std::min(top, canvasHeight);
+    lastWidth = std::min(width, canvasWidth - lastX);
+    lastHeight = std::min(height, canvasHeight - lastY);
+    if (disposal == 3)
+    {
+        saved = canvas;
+    }
+
+    // [-------------- LZW -----------------------]
+    // Codes come out as index strings, written straight to the canvas in
+    // row order (or the four interlace passes)
+    static constexpr int passStart[4] = {0, 4, 2, 1};
+    static constexpr int passStep[4] = {8, 8, 4, 2};
+    uint16_t prefix[maxCodes];
+    unsigned char suffix[maxCodes];
+    unsigned char stack[maxCodes];
+    int clearCode = 1 << minCodeSize;
+    int codeSize = minCodeSize + 1;
+    int nextCode = clearCode + 2;
+    int previous = -1;
+    unsigned char first = 0;
+    uint32_t bits = 0;
+    int bitCount = 0;
+    int pass = 0, row = 0, column = 0;
+    long remaining = static_cast<long>(width) * height;
+    blockSize = blockPos = 0;
+    blocksEnded = false;
+    for (int c = 0; c < clearCode; c++)
+    {
+        suffix[c] = static_cast<unsigned char>(c);
+    }
+
+    while (remaining > 0)
+    {
+        while (bitCount < codeSize)
+        {
+            int byte = nextDataByte();
+            if (byte < 0)
+            {
+                // Some encoders stop short, what is missing stays as it was
+                remaining = 0;
+                break;
+            }
+            bits |= static_cast<uint32_t>(byte) << bitCount;
+            bitCount += 8;
+        }
+        if (remaining == 0)
+        {
+            break;
+        }
+        int code = static_cast<int>(bits & ((1u << codeSize) - 1));
+        bits >>= codeSize;
+        bitCount -= codeSize;
+
+        if (code == clearCode)
+        {
+            codeSize = minCodeSize + 1;
+            nextCode = clearCode + 2;
+            previous = -1;
+            continue;
+        }
+        if (code == clearCode + 1)
+        {
+            break;
+        }
+        int depth = 0;
+        if (previous < 0)
+        {
+            if (code >= clearCode)
+            {
+                return fail("bad LZW code");
+            }
+            first = static_cast<unsigned char>(code);
+            stack[depth++] = first;
+        }
+        else
+        {
+            int in = code;
+            if (code > nextCode || (code == nextCode && nextCode == maxCodes))
+            {
+                return fail("bad LZW code");
+            }
+            if (code == nextCode)
+            {
+                // The string being defined by this very code - previous plus its own first index
+                stack[depth++] = first;
+                code = previous;
+            }
+            while (code >= clearCode)
+            {
+                stack[depth++] = suffix[code];
+                code = prefix[code];
+            }
+            first = static_cast<unsigned char>(code);
+            stack[depth++] = first;
+            if (nextCode < maxCodes)
+            {
+                prefix[nextCode] = static_cast<uint16_t>(previous);
+                suffix[nextCode] = first;
+                nextCode++;
+                if (nextCode == (1 << codeSize) && codeSize < 12)
+                {
+                    codeSize++;
+                }
+            }
+            code = in;
+        }
+        previous = code;
+
+        while (depth > 0 && remaining > 0)
+        {
+            int index = stack[--depth];
+            int x = left + column, y = top + row;
+            if (index != transparent && x < canvasWidth && y < canvasHeight)
+            {
+                uint32_t color = index < paletteSize ? palette[index] : 0xFF000000u;
+                memcpy(&canvas[(static_cast<size_t>(y) * canvasWidth + x) * 4], &color, 4);
+            }
+            remaining--;
+            if (++column == width)
+            {
+                column = 0;
+                row += interlaced ? passStep[pass] : 1;
+                while (interlaced && row >= height && pass < 3)
+                {
+                    pass++;
+                    row = passStart[pass];
+                }
+            }
+        }
+    }
+
+    // Whatever is left of the image data, usually just the terminator
+    while (nextDataByte() >= 0)
+    {
+    }
+    return true;
+}
+
+// [-------------- STREAM -----------------------]
+
+GifStream::GifStream(int ringSize)
+    : ring(std::max(ringSize, 2))
+{
+}
+
+GifStream::~GifStream()
+{
+    {
+        std::lock_guard lock(ringMutex);
+        stopping = true;
+    }
+    slotFreed.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+bool GifStream::open(const char *path)
+{
+    if (!decoder.open(path))
+    {
+        return false;
+    }
+    // Every slot is sized once here, the worker only ever overwrites them
+    for (GifFrame &frame : ring)
+    {
+        frame.rgba.resize(static_cast<size_t>(decoder.width()) * decoder.height() * 4);
+    }
+    worker = std::thread(&GifStream::work, this);
+    return true;
+}
+
+void GifStream::work()
+{
+    int size = static_cast<int>(ring.size());
+    while (true)
+    {
+        int slot;
+        {
+            std::unique_lock lock(ringMutex);
+            slotFreed.wait(lock, [&] { return stopping || count < size; });
+            if (stopping)
+            {
+                return;
+            }
+            slot = (head + count) % size;
+        }
+        // Outside the lock - the reader never looks past head + count
+        bool decoded = decoder.nextFrame(ring[slot]);
+        if (!decoded && decoder.error()[0] == '\0' && decoder.framesRead() > 0)
+        {
+            decoded = decoder.rewind() && decoder.nextFrame(ring[slot]);
+        }
+        if (!decoded)
+        {
+            broken = true;
+            return;
+        }
+        std::lock_guard lock(ringMutex);
+        count++;
+    }
+}
+
+const GifFrame *GifStream::front()
+{
+    std::lock_guard lock(ringMutex);
+    return count > 0 ? &ring[head] : nullptr;
+}
+
+void GifStream::pop()
+{
+    {
+        std::lock_guard lock(ringMutex);
+        if (count == 0)
+        {
+            return;
+        }
+        head = (head + 1) % static_cast<int>(ring.size());
+        count--;
+    }
+    slotFreed.notify_one();
+}
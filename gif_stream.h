@@ -0,0 +1,128 @@
+/**
+ * Streaming animated GIF playback. GifDecoder reads a GIF a frame at a time
+ * off disk - only the composited canvas is kept, never the whole animation -
+ * and GifStream runs one on a worker thread that decodes a few frames ahead
+ * into a fixed ring. Memory is a handful of canvases however long the GIF
+ * is. No GL here, AnimatedTexture puts the frames on screen.
+*/
+
+#ifndef GGJ24_GIF_STREAM_H
+#define GGJ24_GIF_STREAM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GifFrame
+{
+    int delayMs{100};
+    std::vector<unsigned char> rgba;    // the whole canvas, width * height * 4
+};
+
+class GifDecoder
+{
+public:
+    GifDecoder() = default;
+    GifDecoder(const GifDecoder &) = delete;
+    GifDecoder &operator=(const GifDecoder &) = delete;
+    ~GifDecoder();
+
+    // Reads the header and global palette, false (see error()) if path is not a GIF
+    bool open(const char *path);
+
+    int width() const { return canvasWidth; }
+    int height() const { return canvasHeight; }
+
+    // Decodes the next frame over the previous one into frame.rgba. False at
+    // the end of the file, or on a broken one (error() is set then)
+    bool nextFrame(GifFrame &frame);
+    // Back to the first frame with a clear canvas, for looping
+    bool rewind();
+    // Frames decoded since open() or rewind()
+    int framesRead() const { return frames; }
+    const char *error() const { return lastError.c_str(); }
+
+private:
+    bool fail(const char *message);
+    bool readPalette(uint32_t *palette, int size);
+    bool skipSubBlocks();
+    bool readGraphicControl();
+    bool readImage();
+    // Fetches the next byte of LZW data across sub-block boundaries, -1 at the end
+    int nextDataByte();
+    void dispose();
+
+    FILE *file{nullptr};
+    std::string lastError;
+    int canvasWidth{0};
+    int canvasHeight{0};
+    long firstBlock{0};
+    int frames{0};
+
+    uint32_t globalPalette[256]{};
+    int globalPaletteSize{0};
+    uint32_t localPalette[256]{};
+
+    // Graphic control for the next image, reset after each one
+    int delayCs{0};
+    int disposal{0};
+    int transparent{-1};
+
+    // The previous image's disposal, applied before the next one draws
+    int lastDisposal{0};
+    int lastX{0}, lastY{0}, lastWidth{0}, lastHeight{0};
+
+    std::vector<unsigned char> canvas;
+    // Canvas under an image with disposal 3 (restore to previous), only allocated for those
+    std::vector<unsigned char> saved;
+
+    unsigned char block[255]{};
+    int blockSize{0};
+    int blockPos{0};
+    bool blocksEnded{false};
+};
+
+class GifStream
+{
+public:
+    // ringSize frames are decoded ahead, at least 2
+    explicit GifStream(int ringSize = 3);
+    ~GifStream();
+    GifStream(const GifStream &) = delete;
+    GifStream &operator=(const GifStream &) = delete;
+
+    // Opens path on the calling thread and starts decoding on a worker,
+    // looping forever. False if path is not a GIF
+    bool open(const char *path);
+
+    int width() const { return decoder.width(); }
+    int height() const { return decoder.height(); }
+
+    // The oldest decoded frame, null if the worker has not caught up. Stays
+    // valid and unchanged until pop()
+    const GifFrame *front();
+    // Hands front()'s slot back to the worker
+    void pop();
+    // The worker hit a broken frame and stopped, front() stays null once the ring drains
+    bool failed() const { return broken; }
+
+private:
+    void work();
+
+    GifDecoder decoder;
+    std::vector<GifFrame> ring;
+    int head{0};
+    int count{0};
+    bool stopping{false};
+    std::atomic<bool> broken{false};
+    std::mutex ringMutex;
+    std::condition_variable slotFreed;
+    std::thread worker;
+};
+
+#endif //GGJ24_GIF_STREAM_H
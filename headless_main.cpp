@@ -0,0 +1,151 @@
+/**
+ * Headless sim runner - steps the game through the null backend with no
+ * window or GPU and reports ticks per second.
+ *
+ * usage: GGJ24Headless [ticks] [seed] [tickRate] [record] [crowd] [workers] [pipelined]
+ * tickRate is 60, 120 or 240 like the game's --tick-rate, anything else prints
+ * this usage and exits with 1.
+ * A non-zero fourth argument also records every frame's render list and
+ * reports the draw calls it would cost. crowd adds that many clownybara +
+ * grumulum pairs to the arena. workers is the sim's worker thread count,
+ * one per core but this one when left out - the output is the same for any.
+ * A non-zero pipelined runs the sim on its own thread as the game does, ticks
+ * then depend on how fast the two threads go and runs stop being repeatable.
+ *
+ *        GGJ24Headless --save-replay FILE [ticks] [seed] ...
+ *        GGJ24Headless --replay FILE [workers]
+ * --save-replay writes the run's inputs to FILE as the game's --record does.
+ * --replay steps through a recording as fast as it goes and checks the sim
+ * ends where the recording says it did.
+*/
+
+#include "null_backend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static int usage()
+{
+    printf("usage: GGJ24Headless [--save-replay FILE] [ticks] [seed] [tickRate] [record] [crowd] [workers] [pipelined]\n");
+    printf("       GGJ24Headless --replay FILE [workers]\n");
+    printf("tickRate is 60, 120 or 240\n");
+    return 1;
+}
+
+static int replay(const char *path, int workers)
+{
+    ReplayReader replay;
+    if (!replay.open(path))
+    {
+        printf("can't replay %s: %s\n", path, replay.error());
+        return 1;
+    }
+    SimConfig config = replay.config();
+    config.workers = workers;
+    Sim sim(config);
+
+    auto begin = std::chrono::steady_clock::now();
+    long long ticks = runReplay(sim, replay);
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    printf("ticks: %lld\n", ticks);
+    printf("seconds: %f\n", seconds);
+    printf("ticks/sec: %f\n", static_cast<double>(ticks) / seconds);
+    printf("state: %d health: %u grum: %u cappy: %u\n", sim.currentGameState, sim.currentHealth, sim.healthOf(sim.grum), sim.healthOf(sim.cappy));
+    printf("threads: %d\n", sim.jobs.threadCount());
+    if (replay.error()[0] != '\0')
+    {
+        printf("replay broken after %lld ticks: %s\n", ticks, replay.error());
+        return 1;
+    }
+    if (!replay.finished())
+    {
+        printf("checksum: %016llx (recording cut short, nothing to check)\n", static_cast<unsigned long long>(sim.checksum()));
+        return 0;
+    }
+    bool matches = ticks == replay.recordedTicks() && sim.checksum() == replay.recordedChecksum();
+    printf("checksum: %016llx recorded %016llx over %lld ticks, %s\n", static_cast<unsigned long long>(sim.checksum()),
+           static_cast<unsigned long long>(replay.recordedChecksum()), replay.recordedTicks(), matches ? "match" : "DESYNC");
+    return matches ? 0 : 2;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0)
+    {
+        return replay(argv[2], argc > 3 ? std::atoi(argv[3]) : -1);
+    }
+    const char *recordPath = nullptr;
+    if (argc > 2 && strcmp(argv[1], "--save-replay") == 0)
+    {
+        // The rest are the usual arguments
+        recordPath = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+
+    long long ticks = argc > 1 ? std::atoll(argv[1]) : 100000;
+    unsigned int seed = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    int tickRate = argc > 3 ? std::atoi(argv[3]) : 60;
+    if (tickRate != 60 && tickRate != 120 && tickRate != 240)
+    {
+        return usage();
+    }
+    bool recordFrames = argc > 4 && std::atoi(argv[4]) != 0;
+    int crowd = argc > 5 ? std::atoi(argv[5]) : 0;
+    int workers = argc > 6 ? std::atoi(argv[6]) : -1;
+    bool pipelined = argc > 7 && std::atoi(argv[7]) != 0;
+
+    SimConfig config;
+    config.seed = seed;
+    config.tickRate = tickRate;
+    config.crowd = crowd;
+    config.workers = workers;
+    Sim sim(config);
+    // One backend frame per sim tick
+    NullBackend backend(ticks, sim.tickSeconds(), recordFrames);
+    ReplayWriter recording;
+    if (recordPath != nullptr && !recording.open(recordPath, config))
+    {
+        printf("can't record to %s\n", recordPath);
+        return 1;
+    }
+    ReplayWriter *writer = recordPath != nullptr ? &recording : nullptr;
+
+    auto begin = std::chrono::steady_clock::now();
+    if (pipelined)
+    {
+        runPipelinedSimLoop(sim, backend, writer);
+    }
+    else
+    {
+        runSimLoop(sim, backend, writer);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    printf("ticks: %lld\n", sim.tick);
+    printf("seconds: %f\n", seconds);
+    printf("ticks/sec: %f\n", static_cast<double>(sim.tick) / seconds);
+    printf("projectile-frames: %lld\n", backend.activeProjectiles());
+    if (recordFrames)
+    {
+        long long frames = std::max(1LL, backend.framesPresented());
+        printf("draw calls/frame: %.2f (worst %d) vertices/frame: %.1f instances/frame: %.2f\n",
+               static_cast<double>(backend.drawCalls()) / frames, backend.maxDrawCalls(),
+               static_cast<double>(backend.vertices()) / frames, static_cast<double>(backend.instances()) / frames);
+        printf("culling/frame: %.1f visible %.1f culled\n",
+               static_cast<double>(backend.culledVisible()) / frames, static_cast<double>(backend.culled()) / frames);
+    }
+    printf("pies: %d / %d peak %d overflow %lld\n", sim.pies.activeCount(), sim.pies.capacity(), sim.pies.highWaterMark(), sim.pies.overflowCount());
+    printf("shots: %d / %d peak %d overflow %lld\n", sim.playerProjectiles.activeCount(), sim.playerProjectiles.capacity(), sim.playerProjectiles.highWaterMark(), sim.playerProjectiles.overflowCount());
+    printf("state: %d health: %u grum: %u cappy: %u\n", sim.currentGameState, sim.currentHealth, sim.healthOf(sim.grum), sim.healthOf(sim.cappy));
+    printf("entities: %d in %d archetypes\n", sim.world.entityCount(), sim.world.archetypeCount());
+    printf("threads: %d\n", sim.jobs.threadCount());
+    printf("checksum: %016llx\n", static_cast<unsigned long long>(sim.checksum()));
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include "job_system.h"
+
+// Rounds a worker spins looking for work before it goes to sleep - jobs come
+// in bursts a tick apart, waking up costs more than a short spin
+constexpr int idleSpins{64};
+
+// Which pool (if any) the calling thread works for, and its queue there
+static thread_local const JobSystem *currentSystem{nullptr};
+static thread_local int currentQueue{0};
+
+JobSystem::JobSystem(int workerCount)
+{
+    if (workerCount < 0)
+    {
+        workerCount = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i <= workerCount; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 1; i <= workerCount; i++)
+    {
+        workers.emplace_back(&JobSystem::work, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    jobQueued.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int JobSystem::queueOfThisThread() const
+{
+    return currentSystem == this ? currentQueue : 0;
+}
+
+void JobSystem::push(const Job &job)
+{
+    Queue &queue = *queues[queueOfThisThread()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    // Counted under the sleep lock, so a worker about to sleep can't miss it
+    {
+        std::lock_guard lock(sleepMutex);
+        queued++;
+    }
+    jobQueued.notify_one();
+}
+
+bool JobSystem::take(int queue, Job &job)
+{
+    {
+        Queue &own = *queues[queue];
+        std::lock_guard lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    // Start with the next queue along so thieves spread over their victims
+    int count = static_cast<int>(queues.size());
+    for (int i = 1; i < count; i++)
+    {
+        Queue &victim = *queues[(queue + i) % count];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(const Job &job)
+{
+    job.run(job.context, job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::wait(const std::atomic<int> &pending)
+{
+    int queue = queueOfThisThread();
+    Job job;
+    while (pending.load(std::memory_order_acquire) > 0)
+    {
+        if (take(queue, job))
+        {
+            execute(job);
+        }
+        else
+        {
+            // What is left is running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::work(int queue)
+{
+    currentSystem = this;
+    currentQueue = queue;
+    Job job;
+    int idle = 0;
+    while (true)
+    {
+        if (take(queue, job))
+        {
+            execute(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < idleSpins)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock lock(sleepMutex);
+        jobQueued.wait(lock, [&] { return stopping || queued > 0; });
+        if (stopping)
+        {
+            return;
+        }
+        idle = 0;
+    }
+}
+
+// [-------------- TASK GRAPH -----------------------]
+
+int TaskGraph::add(std::function<void()> fn, std::initializer_list<int> dependencies)
+{
+    int id = static_cast<int>(tasks.size());
+    tasks.push_back({std::move(fn), {}, 0});
+    for (int dependency : dependencies)
+    {
+        tasks[dependency].dependents.push_back(id);
+        tasks[id].dependencies++;
+    }
+    return id;
+}
+
+void TaskGraph::run(JobSystem &jobs)
+{
+    if (waitingSize != size())
+    {
+        waiting = std::make_unique<std::atomic<int>[]>(tasks.size());
+        waitingSize = size();
+    }
+    for (int i = 0; i < size(); i++)
+    {
+        waiting[i].store(tasks[i].dependencies, std::memory_order_relaxed);
+    }
+    system = &jobs;
+    pending.store(size(), std::memory_order_release);
+
+    for (int i = 0; i < size(); i++)
+    {
+        if (tasks[i].dependencies == 0)
+        {
+            queue(i);
+        }
+    }
+    jobs.wait(pending);
+}
+
+void TaskGraph::queue(int task)
+{
+    system->push({&TaskGraph::runTask, this, task, task + 1, &pending});
+}
+
+void TaskGraph::runTask(void *context, int task, int)
+{
+    TaskGraph &graph = *static_cast<TaskGraph *>(context);
+    graph.tasks[task].fn();
+    // Whoever finishes a task's last dependency starts it
+    for (int dependent : graph.tasks[task].dependents)
+    {
+        if (graph.waiting[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            graph.queue(dependent);
+        }
+    }
+}
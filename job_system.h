@@ -0,0 +1,144 @@
+/**
+ * Work-stealing job system. A fixed pool of workers, each with a deque of
+ * its own: a thread pushes and pops at the back of its deque (newest first,
+ * still warm in cache) and once that runs dry steals from the front of
+ * someone else's (oldest first, usually the biggest piece left). Threads
+ * waiting on jobs - the one calling parallelFor() or TaskGraph::run() as
+ * well - run jobs while they wait rather than block, so a parallelFor inside
+ * a job can't deadlock. Jobs are a function pointer, a context and a range,
+ * never allocated, and the deques are only touched once per chunk of work.
+*/
+
+#ifndef GGJ24_JOB_SYSTEM_H
+#define GGJ24_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+    struct Job
+    {
+        void (*run)(void *context, int begin, int end);
+        void *context;
+        int begin;
+        int end;
+        std::atomic<int> *pending;      // dropped by one once the job is done
+    };
+
+    // workers threads besides the caller, -1 for one per core but the caller's.
+    // With 0 everything runs on the calling thread
+    explicit JobSystem(int workers = -1);
+    ~JobSystem();
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Threads work is spread over, the caller included
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    // fn(begin, end) over [0, count) in chunks of grain (the last one shorter),
+    // returns once every chunk is done. Chunks always start on a multiple of grain
+    template<typename F>
+    void parallelFor(int count, int grain, F &&fn);
+
+    // Queues job on the calling thread's deque, *job.pending must already count it
+    void push(const Job &job);
+    // Runs whatever jobs there are until pending drops to zero
+    void wait(const std::atomic<int> &pending);
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    // The back of queue's own deque, or else the front of another one
+    bool take(int queue, Job &job);
+    void execute(const Job &job);
+    void work(int queue);
+    // Queue of the calling thread - its own for workers, 0 for everyone else
+    int queueOfThisThread() const;
+
+    // [0] is shared by every thread outside the pool, [1..] belong to the workers
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    // Jobs pushed and not yet taken, workers sleep while it is zero
+    std::atomic<int> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable jobQueued;
+    bool stopping{false};
+};
+
+// Jobs with dependencies, built once and run as often as needed. A task
+// starts as soon as every task it depends on is done, on whichever thread
+// gets to it first
+class TaskGraph
+{
+public:
+    // fn runs once per run(), after every task in dependencies (ids from
+    // earlier add()s, so there can't be a cycle). Returns its id
+    int add(std::function<void()> fn, std::initializer_list<int> dependencies = {});
+    // Runs every task, returns once all of them are done
+    void run(JobSystem &jobs);
+
+    int size() const { return static_cast<int>(tasks.size()); }
+
+private:
+    struct Task
+    {
+        std::function<void()> fn;
+        std::vector<int> dependents;
+        int dependencies{0};
+    };
+
+    static void runTask(void *context, int task, int);
+    // Queues task on the calling thread, to start once something takes it
+    void queue(int task);
+
+    std::vector<Task> tasks;
+    // Dependencies each task is still waiting on this run
+    std::unique_ptr<std::atomic<int>[]> waiting;
+    int waitingSize{0};
+    std::atomic<int> pending{0};
+    JobSystem *system{nullptr};
+};
+
+// [-------------- TEMPLATES -----------------------]
+
+template<typename F>
+void JobSystem::parallelFor(int count, int grain, F &&fn)
+{
+    grain = std::max(grain, 1);
+    if (count <= grain || workers.empty())
+    {
+        if (count > 0)
+        {
+            fn(0, count);
+        }
+        return;
+    }
+
+    auto body = [&fn](int begin, int end) { fn(begin, end); };
+    auto run = [](void *context, int begin, int end) { (*static_cast<decltype(body) *>(context))(begin, end); };
+    // The caller keeps the first chunk and helps with the rest once it is done
+    int chunks = (count + grain - 1) / grain;
+    std::atomic<int> pending{chunks - 1};
+    for (int c = 1; c < chunks; c++)
+    {
+        push({run, &body, c * grain, std::min(count, (c + 1) * grain), &pending});
+    }
+    body(0, grain);
+    wait(pending);
+}
+
+#endif //GGJ24_JOB_SYSTEM_H
@@ -0,0 +1,66 @@
+#include "null_backend.h"
+
+#include <algorithm>
+
+NullBackend::NullBackend(long long maxFrames, float frameSeconds, bool recordFrames)
+    : maxFrames(maxFrames), frameSeconds(frameSeconds), recordFrames(recordFrames)
+{
+    // No art headless, batching only needs to see a texture
+    useStandInAtlas(assets);
+    assets.hearts.resize(Sim::maxHealth);
+    for (auto &heart : assets.hearts)
+    {
+        heart.full = spriteFrame(assets, SPRITE_FULL_HEART);
+        heart.empty = spriteFrame(assets, SPRITE_EMPTY_HEART);
+        heart.isFull = true;
+    }
+}
+
+bool NullBackend::shouldClose()
+{
+    return frames >= maxFrames;
+}
+
+float NullBackend::frameTime()
+{
+    return frameSeconds;
+}
+
+SimInputs NullBackend::pollInputs(const SimSnapshot &snapshot)
+{
+    // Scripted player: start/restart straight away, strafe back and forth,
+    // sweep the view and fire every few frames
+    SimInputs inputs;
+    inputs.start = snapshot.state == START_SCREEN;
+    inputs.restart = snapshot.state != PLAYING && snapshot.state != START_SCREEN;
+    inputs.moveLeft = (frames / 120) % 2 == 0;
+    inputs.moveRight = !inputs.moveLeft;
+    inputs.fire = frames % 8 == 0;
+    inputs.jump = frames % 300 == 0;
+    inputs.mouseDelta = {(frames / 240) % 2 == 0 ? 2.f : -2.f, 0.f};
+    return inputs;
+}
+
+void NullBackend::present(const SimSnapshot &snapshot, float alpha)
+{
+    // Touch what a renderer would read so the work is not optimised away
+    projectilesSeen += static_cast<long long>(snapshot.pies.size());
+    projectilesSeen += static_cast<long long>(snapshot.shots.size());
+    if (recordFrames)
+    {
+        recordScene(snapshot, alpha, assets, {}, renderList);
+        renderList.sort();
+        RenderStats stats = renderList.stats();
+        totalDrawCalls += stats.drawCalls;
+        totalVertices += stats.vertices;
+        totalInstances += stats.instances;
+        worstDrawCalls = std::max(worstDrawCalls, stats.drawCalls);
+        // Only the playing view culls, menus would repeat the last frame's counts
+        if (snapshot.state == PLAYING)
+        {
+            totalVisible += assets.culler.stats().visible;
+            totalCulled += assets.culler.stats().culled;
+        }
+    }
+    frames++;
+}
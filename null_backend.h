@@ -0,0 +1,54 @@
+/**
+ * Null front end - no window, no GL context, no textures.
+ * Feeds the sim a scripted input stream at a fixed frame time so the whole
+ * game can be run, profiled and benchmarked headless. With recordFrames it
+ * also records and sorts every frame's render list against stand-in
+ * textures, to measure draw calls without a GPU.
+*/
+
+#ifndef GGJ24_NULL_BACKEND_H
+#define GGJ24_NULL_BACKEND_H
+
+#include "backend.h"
+#include "render_list.h"
+#include "scene.h"
+
+class NullBackend : public Backend
+{
+public:
+    NullBackend(long long maxFrames, float frameSeconds, bool recordFrames = false);
+
+    bool shouldClose() override;
+    float frameTime() override;
+    SimInputs pollInputs(const SimSnapshot &snapshot) override;
+    void present(const SimSnapshot &snapshot, float alpha) override;
+
+    long long framesPresented() const { return frames; }
+    long long activeProjectiles() const { return projectilesSeen; }
+    // Summed over every recorded frame, maxDrawCalls is the worst single frame
+    long long drawCalls() const { return totalDrawCalls; }
+    long long vertices() const { return totalVertices; }
+    long long instances() const { return totalInstances; }
+    int maxDrawCalls() const { return worstDrawCalls; }
+    // Frustum test results, summed over the recorded playing frames
+    long long culledVisible() const { return totalVisible; }
+    long long culled() const { return totalCulled; }
+
+private:
+    long long maxFrames;
+    float frameSeconds;
+    long long frames{0};
+    long long projectilesSeen{0};
+
+    bool recordFrames;
+    SceneAssets assets;
+    RenderList renderList;
+    long long totalDrawCalls{0};
+    long long totalVertices{0};
+    long long totalInstances{0};
+    int worstDrawCalls{0};
+    long long totalVisible{0};
+    long long totalCulled{0};
+};
+
+#endif //GGJ24_NULL_BACKEND_H
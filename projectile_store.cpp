@@ -0,0 +1,210 @@
+#include "projectile_store.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GGJ24_SIMD_X86 1
+#endif
+
+// Widest kernel is 8 floats, columns are padded so loads never cross the end
+constexpr int simdWidth{8};
+
+struct ProjectileColumns
+{
+    float *x, *y, *z;
+    const float *vx, *vy, *vz;
+    float *t;
+};
+
+// [-------------- INTEGRATE + EXPIRE KERNELS -----------------------]
+// Each kernel moves and ages [begin, count) and writes the dense index of
+// every projectile that reached lifetime into expired, returning how many.
+
+static int integrateScalar(const ProjectileColumns &c, int begin, int count, float dT, float lifetime, int *expired)
+{
+    int expiredCount = 0;
+    for (int i = begin; i < count; i++)
+    {
+        c.x[i] += c.vx[i] * dT;
+        c.y[i] += c.vy[i] * dT;
+        c.z[i] += c.vz[i] * dT;
+        c.t[i] += dT;
+        if (c.t[i] >= lifetime)
+        {
+            expired[expiredCount++] = i;
+        }
+    }
+    return expiredCount;
+}
+
+#ifdef GGJ24_SIMD_X86
+static int integrateSse(const ProjectileColumns &c, int count, float dT, float lifetime, int *expired)
+{
+    const __m128 step = _mm_set1_ps(dT);
+    const __m128 limit = _mm_set1_ps(lifetime);
+    int expiredCount = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(c.x + i, _mm_add_ps(_mm_loadu_ps(c.x + i), _mm_mul_ps(_mm_loadu_ps(c.vx + i), step)));
+        _mm_storeu_ps(c.y + i, _mm_add_ps(_mm_loadu_ps(c.y + i), _mm_mul_ps(_mm_loadu_ps(c.vy + i), step)));
+        _mm_storeu_ps(c.z + i, _mm_add_ps(_mm_loadu_ps(c.z + i), _mm_mul_ps(_mm_loadu_ps(c.vz + i), step)));
+        __m128 t = _mm_add_ps(_mm_loadu_ps(c.t + i), step);
+        _mm_storeu_ps(c.t + i, t);
+
+        int mask = _mm_movemask_ps(_mm_cmpge_ps(t, limit));
+        while (mask)
+        {
+            expired[expiredCount++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    return expiredCount + integrateScalar(c, i, count, dT, lifetime, expired + expiredCount);
+}
+
+__attribute__((target("avx2")))
+static int integrateAvx2(const ProjectileColumns &c, int count, float dT, float lifetime, int *expired)
+{
+    const __m256 step = _mm256_set1_ps(dT);
+    const __m256 limit = _mm256_set1_ps(lifetime);
+    int expiredCount = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(c.x + i, _mm256_add_ps(_mm256_loadu_ps(c.x + i), _mm256_mul_ps(_mm256_loadu_ps(c.vx + i), step)));
+        _mm256_storeu_ps(c.y + i, _mm256_add_ps(_mm256_loadu_ps(c.y + i), _mm256_mul_ps(_mm256_loadu_ps(c.vy + i), step)));
+        _mm256_storeu_ps(c.z + i, _mm256_add_ps(_mm256_loadu_ps(c.z + i), _mm256_mul_ps(_mm256_loadu_ps(c.vz + i), step)));
+        __m256 t = _mm256_add_ps(_mm256_loadu_ps(c.t + i), step);
+        _mm256_storeu_ps(c.t + i, t);
+
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(t, limit, _CMP_GE_OQ));
+        while (mask)
+        {
+            expired[expiredCount++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    // The scalar tail is legacy SSE code, dirty upper halves make every SSE op after this crawl
+    _mm256_zeroupper();
+    return expiredCount + integrateScalar(c, i, count, dT, lifetime, expired + expiredCount);
+}
+#endif
+
+ProjectileStore::ProjectileStore(int capacity)
+{
+    int padded = (capacity + simdWidth - 1) / simdWidth * simdWidth;
+    for (auto *column : {&x, &y, &z, &vx, &vy, &vz, &timeAlive})
+    {
+        column->assign(padded, 0.f);
+    }
+    idLink.resize(capacity);
+    denseToId.resize(capacity);
+    expired.resize(capacity);
+    clear();
+}
+
+int ProjectileStore::spawn(Vector3 position, Vector3 speed)
+{
+    if (freeHead < 0)
+    {
+        overflows++;
+        return -1;
+    }
+
+    int projectileId = freeHead;
+    freeHead = idLink[projectileId];
+
+    int index = count++;
+    idLink[projectileId] = index;
+    denseToId[index] = projectileId;
+    if (count > highWater)
+    {
+        highWater = count;
+    }
+
+    x[index] = position.x;
+    y[index] = position.y;
+    z[index] = position.z;
+    vx[index] = speed.x;
+    vy[index] = speed.y;
+    vz[index] = speed.z;
+    timeAlive[index] = 0.f;
+    return index;
+}
+
+int ProjectileStore::spawnOrRecycleOldest(Vector3 position, Vector3 speed)
+{
+    int index = spawn(position, speed);
+    if (index >= 0 || count == 0)
+    {
+        return index;
+    }
+
+    int oldest = 0;
+    for (int i = 1; i < count; i++)
+    {
+        if (timeAlive[i] > timeAlive[oldest])
+        {
+            oldest = i;
+        }
+    }
+    x[oldest] = position.x;
+    y[oldest] = position.y;
+    z[oldest] = position.z;
+    vx[oldest] = speed.x;
+    vy[oldest] = speed.y;
+    vz[oldest] = speed.z;
+    timeAlive[oldest] = 0.f;
+    return oldest;
+}
+
+void ProjectileStore::releaseActive(int index)
+{
+    int projectileId = denseToId[index];
+    int last = --count;
+    if (index != last)
+    {
+        x[index] = x[last];
+        y[index] = y[last];
+        z[index] = z[last];
+        vx[index] = vx[last];
+        vy[index] = vy[last];
+        vz[index] = vz[last];
+        timeAlive[index] = timeAlive[last];
+        denseToId[index] = denseToId[last];
+        idLink[denseToId[index]] = index;
+    }
+
+    idLink[projectileId] = freeHead;
+    freeHead = projectileId;
+}
+
+void ProjectileStore::clear()
+{
+    count = 0;
+    freeHead = -1;
+    for (int projectileId = capacity() - 1; projectileId >= 0; projectileId--)
+    {
+        idLink[projectileId] = freeHead;
+        freeHead = projectileId;
+    }
+}
+
+void ProjectileStore::integrate(float dT, float lifetime)
+{
+    ProjectileColumns columns{x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data(), timeAlive.data()};
+
+    int expiredCount;
+#ifdef GGJ24_SIMD_X86
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    expiredCount = hasAvx2 ? integrateAvx2(columns, count, dT, lifetime, expired.data())
+                           : integrateSse(columns, count, dT, lifetime, expired.data());
+#else
+    expiredCount = integrateScalar(columns, 0, count, dT, lifetime, expired.data());
+#endif
+
+    // Back to front, so whatever gets swapped into a released slot is always still alive
+    for (int i = expiredCount - 1; i >= 0; i--)
+    {
+        releaseActive(expired[i]);
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * Structure-of-arrays projectile store, used for player shots.
+ * Live projectiles sit densely packed in [0, activeCount()) of the x/y/z,
+ * vx/vy/vz and timeAlive columns (swap-remove on release), so integration
+ * is one straight SIMD pass. Each projectile also gets a stable id from an
+ * intrusive free list, for anything that needs to refer to it across ticks.
+*/
+
+#ifndef GGJ24_PROJECTILE_STORE_H
+#define GGJ24_PROJECTILE_STORE_H
+
+#include "raylib.h"
+
+#include <vector>
+
+class ProjectileStore
+{
+public:
+    explicit ProjectileStore(int capacity);
+
+    // Returns the dense index of the new projectile, or -1 (and counts an overflow) when full
+    int spawn(Vector3 position, Vector3 speed);
+    // Same as spawn() but reuses the longest-lived projectile when full, O(activeCount) in that case
+    int spawnOrRecycleOldest(Vector3 position, Vector3 speed);
+    // Release by dense index - the last projectile is swapped into index, so
+    // loops that release should not advance
+    void releaseActive(int index);
+    // Release by stable id, safe to call for several ids in a row
+    void releaseId(int projectileId) { releaseActive(idLink[projectileId]); }
+    void clear();
+
+    // Moves every live projectile by speed * dT, ages it, then releases the
+    // ones that have lived for lifetime seconds. AVX2/SSE with a scalar fallback.
+    void integrate(float dT, float lifetime);
+
+    int activeCount() const { return count; }
+    Vector3 position(int index) const { return {x[index], y[index], z[index]}; }
+    Vector3 speed(int index) const { return {vx[index], vy[index], vz[index]}; }
+    int id(int index) const { return denseToId[index]; }
+
+    // [-------------- SIZING COUNTERS -----------------------]
+    int capacity() const { return static_cast<int>(idLink.size()); }
+    int highWaterMark() const { return highWater; }
+    long long overflowCount() const { return overflows; }
+
+    // [-------------- COLUMNS -----------------------]
+    // Padded to a multiple of the SIMD width, only [0, activeCount()) is live
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> timeAlive;
+
+private:
+    std::vector<int> idLink;    // next free id while free, dense index while live
+    std::vector<int> denseToId;
+    std::vector<int> expired;   // scratch for integrate()
+    int count{0};
+    int freeHead{-1};
+    int highWater{0};
+    long long overflows{0};
+};
+
+#endif //GGJ24_PROJECTILE_STORE_H
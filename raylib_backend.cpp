@@ -0,0 +1,346 @@
+#include "raylib_backend.h"
+
+#include "atlas_frames.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <algorithm>
+#include <iterator>
+
+// GL time a frame may spend uploading textures while the start screen is up
+constexpr double uploadBudgetSeconds{0.004};
+// Decoded a few frames ahead off disk, never loaded whole
+constexpr const char *bannerPath{"assets/art/clownybara.gif"};
+
+// Flat colour with a per-instance model matrix, raylib's default shader has no instancing
+static const char *instancingVertexShader = R"(#version 330
+in vec3 vertexPosition;
+in mat4 instanceTransform;
+uniform mat4 mvp;
+void main()
+{
+    gl_Position = mvp * instanceTransform * vec4(vertexPosition, 1.0);
+}
+)";
+
+static const char *instancingFragmentShader = R"(#version 330
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main()
+{
+    finalColor = colDiffuse;
+}
+)";
+
+RaylibBackend::RaylibBackend()
+{
+    // [----------------- WINDOW INITILIZATION -----------------]
+    // No FPS cap - the sim ticks at a fixed rate and rendering interpolates between ticks
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    InitWindow(Sim::screenWidth, Sim::screenHeight, "KlausRaynor's GGJ24 Entry - Clownybara");
+    DisableCursor();
+
+    // [----------------- Load Textures -----------------]
+    // Every sprite is packed into the atlas at build time (GGJ24Atlas). The
+    // pre-decoded pack only costs the uploads. Without one the PNG pages
+    // decode in the background, present() uploads them while the start
+    // screen is up and finishLoading() hands them to the scene
+    assets.atlasPages.resize(atlasPageCount);
+    std::copy(std::begin(atlasSpritePages), std::end(atlasSpritePages), assets.spritePages);
+    std::copy(std::begin(atlasFrames), std::end(atlasFrames), assets.frames);
+    if (loadAtlasPack())
+    {
+        finishLoading();
+    }
+    else
+    {
+        std::vector<std::string> paths;
+        for (const AtlasPage &page : atlasPages)
+        {
+            paths.emplace_back(page.path);
+        }
+        loader = std::make_unique<AssetLoader>(textures, std::move(paths));
+        assets.loaded = 0.f;
+    }
+
+    banner = std::make_unique<AnimatedTexture>();
+    if (!banner->open(bannerPath))
+    {
+        banner.reset();
+    }
+
+    // [----------------- INSTANCED MESHES -----------------]
+    instancingShader = LoadShaderFromMemory(instancingVertexShader, instancingFragmentShader);
+    instancingShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(instancingShader, "mvp");
+    instancingShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(instancingShader, "instanceTransform");
+    instancingMaterial = LoadMaterialDefault();
+    instancingMaterial.shader = instancingShader;
+    meshes[MESH_PROJECTILE] = GenMeshCube(0.2f, 0.2f, 0.2f);
+    // Baked meshes carry their own vertex colours, the default shader multiplies them by the tint
+    defaultMaterial = LoadMaterialDefault();
+}
+
+bool RaylibBackend::loadAtlasPack()
+{
+    AssetPack pack;
+    if (!pack.open(atlasPackPath))
+    {
+        TraceLog(LOG_WARNING, "ASSETS: No usable %s, decoding the PNG pages", atlasPackPath);
+        return false;
+    }
+    std::vector<TextureHandle> pages;
+    for (const AtlasPage &page : atlasPages)
+    {
+        int index = pack.find(page.path);
+        if (index < 0)
+        {
+            TraceLog(LOG_WARNING, "ASSETS: %s is not in %s, decoding the PNG pages", page.path, atlasPackPath);
+            return false;
+        }
+        // Uploaded straight out of the mapping, no copy and no decode
+        const AssetPackEntry &entry = pack.entry(index);
+        Image image{const_cast<void *>(pack.pixels(index)), entry.width, entry.height, entry.mipmaps, entry.format};
+        pages.push_back(textures.upload(page.path, entry.hash, image));
+    }
+    // The GPU has its own copy now, the pack unmaps on return
+    atlasTextures = std::move(pages);
+    return true;
+}
+
+void RaylibBackend::finishLoading()
+{
+    // The handles keep the pages alive, SceneAssets only copies them
+    for (int page = 0; page < atlasPageCount; page++)
+    {
+        assets.atlasPages[page] = atlasTextures[page].texture();
+    }
+    assets.loaded = 1.f;
+
+    // HEARTS UI - every heart draws the same two frames
+    assets.hearts.resize(Sim::maxHealth);
+    for (auto &heart : assets.hearts)
+    {
+        heart.full = spriteFrame(assets, SPRITE_FULL_HEART);
+        heart.empty = spriteFrame(assets, SPRITE_EMPTY_HEART);
+        heart.isFull = true;
+    }
+
+    // GRUM HEARTS
+    for (auto &[full, empty, isFull, rec] : assets.grumHearts)
+    {
+        full = spriteFrame(assets, SPRITE_FULL_HEART);
+        empty = spriteFrame(assets, SPRITE_EMPTY_HEART);
+        isFull = true;
+    }
+}
+
+RaylibBackend::~RaylibBackend()
+{
+    //[-----------------UNLOAD TEXTURES -----------------]
+    // Dropping the last handles unloads them, this has to happen before CloseWindow()
+    loader.reset();
+    atlasTextures.clear();
+    banner.reset();
+    for (Mesh &mesh : meshes)
+    {
+        UnloadMesh(mesh);
+    }
+    // Also unloads the instancing shader
+    UnloadMaterial(instancingMaterial);
+    UnloadMaterial(defaultMaterial);
+    CloseWindow();
+}
+
+bool RaylibBackend::shouldClose()
+{
+    return WindowShouldClose();
+}
+
+float RaylibBackend::frameTime()
+{
+    return GetFrameTime();
+}
+
+SimInputs RaylibBackend::pollInputs(const SimSnapshot &)
+{
+    SimInputs inputs;
+    inputs.moveForward = IsKeyDown(KEY_W);
+    inputs.moveBack = IsKeyDown(KEY_S);
+    inputs.moveLeft = IsKeyDown(KEY_A);
+    inputs.moveRight = IsKeyDown(KEY_D);
+    inputs.sprint = IsKeyDown(KEY_LEFT_SHIFT);
+    inputs.crouch = IsKeyDown(KEY_SPACE);
+    inputs.crouchReleased = IsKeyReleased(KEY_SPACE);
+    inputs.jump = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
+    inputs.fire = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    // Nothing to play with until the textures are in
+    inputs.start = IsKeyPressed(KEY_SPACE) && loader == nullptr;
+    inputs.restart = IsKeyPressed(KEY_R);
+    inputs.anyKeyPressed = GetKeyPressed() != 0;
+    inputs.mouseDelta = GetMouseDelta();
+
+    if (IsKeyReleased(KEY_P))
+    {
+        debug.showDebugText = !debug.showDebugText;
+    }
+    return inputs;
+}
+
+void RaylibBackend::present(const SimSnapshot &snapshot, float alpha)
+{
+    if (loader != nullptr)
+    {
+        if (loader->pump(uploadBudgetSeconds))
+        {
+            for (int page = 0; page < atlasPageCount; page++)
+            {
+                atlasTextures.push_back(loader->handle(page));
+            }
+            loader.reset();
+            finishLoading();
+        }
+        else
+        {
+            assets.loaded = loader->progress();
+        }
+    }
+    if (banner != nullptr && snapshot.state != PLAYING)
+    {
+        banner->update(GetFrameTime());
+        assets.banner = banner->texture();
+    }
+    debug.fps = GetFPS();
+    debug.textureCount = textures.residentCount();
+    debug.textureBytes = textures.residentBytes();
+    recordScene(snapshot, alpha, assets, debug, renderList);
+    uploadArena();
+    renderList.sort();
+    // The overlay shows the cost of the frame before the one it is drawn in
+    debug.lastFrame = renderList.stats();
+    submit(renderList);
+}
+
+void RaylibBackend::uploadArena()
+{
+    const ArenaMesh &arena = assets.arena;
+    if (arena.revision() == uploadedArenaRevision)
+    {
+        return;
+    }
+
+    UnloadMesh(meshes[MESH_ARENA]);
+    Mesh mesh{};
+    mesh.vertexCount = arena.triangleVertexCount();
+    mesh.triangleCount = mesh.vertexCount / 3;
+    mesh.vertices = const_cast<float *>(arena.triangleVertices().data());
+    mesh.colors = const_cast<unsigned char *>(arena.triangleColors().data());
+    if (mesh.vertexCount > 0)
+    {
+        UploadMesh(&mesh, false);
+    }
+    // The CPU copy stays with the ArenaMesh, UnloadMesh() must not free it
+    mesh.vertices = nullptr;
+    mesh.colors = nullptr;
+    meshes[MESH_ARENA] = mesh;
+    uploadedArenaRevision = arena.revision();
+}
+
+void RaylibBackend::submit(const RenderList &list)
+{
+    // [----------------- BEGIN DRAWING -----------------]
+    BeginDrawing();
+    ClearBackground(list.clearColor());
+
+    bool inWorld = false;
+    int blendMode = -1;
+    for (const RenderCommand &command : list.commands())
+    {
+        bool world = list.passOf(command) == PASS_WORLD;
+        if (world != inWorld)
+        {
+            if (inWorld)
+            {
+                EndMode3D();
+            }
+            else
+            {
+                BeginMode3D(list.camera());
+            }
+            inWorld = world;
+        }
+        if (list.blendModeOf(command) != blendMode)
+        {
+            blendMode = list.blendModeOf(command);
+            BeginBlendMode(blendMode);
+        }
+
+        switch (command.primitive)
+        {
+            case PRIM_CUBE:
+                DrawCubeV(command.position, command.size, command.color);
+                break;
+            case PRIM_CUBE_WIRES:
+                DrawCubeWiresV(command.position, command.size, command.color);
+                break;
+            case PRIM_PLANE:
+                DrawPlane(command.position, {command.size.x, command.size.z}, command.color);
+                break;
+            case PRIM_BILLBOARD:
+                DrawBillboardPro(list.camera(), command.texture, command.source, command.position, {0.f, 1.f, 0.f},
+                                 {command.size.x, command.size.y}, {0.f, 0.f}, 0.f, command.color);
+                break;
+            case PRIM_TEXTURE:
+                DrawTexturePro(command.texture, command.source,
+                               {command.position.x, command.position.y, command.source.width * command.size.x, command.source.height * command.size.x},
+                               {0.f, 0.f}, 0.f, command.color);
+                break;
+            case PRIM_RECTANGLE:
+                DrawRectangle(static_cast<int>(command.source.x), static_cast<int>(command.source.y),
+                              static_cast<int>(command.source.width), static_cast<int>(command.source.height), command.color);
+                break;
+            case PRIM_TEXT:
+            {
+                const char *text = list.textOf(command);
+                int x = static_cast<int>(command.position.x);
+                if (command.centred)
+                {
+                    x -= MeasureText(text, command.fontSize) / 2;
+                }
+                DrawText(text, x, static_cast<int>(command.position.y), command.fontSize, command.color);
+                break;
+            }
+            case PRIM_MESH_INSTANCES:
+                instancingMaterial.maps[MATERIAL_MAP_DIFFUSE].color = command.color;
+                DrawMeshInstanced(meshes[command.mesh], instancingMaterial, list.instancesOf(command), command.instanceCount);
+                break;
+            case PRIM_MESH:
+                defaultMaterial.maps[MATERIAL_MAP_DIFFUSE].color = command.color;
+                DrawMesh(meshes[command.mesh], defaultMaterial, MatrixIdentity());
+                break;
+            case PRIM_LINES:
+                // Whole boxes at a time so rlgl can flush between them, never mid-list
+                for (int first = 0; first < command.vertexCount; first += 24)
+                {
+                    int count = std::min(24, command.vertexCount - first);
+                    rlCheckRenderBatchLimit(count);
+                    rlBegin(RL_LINES);
+                    for (int v = first; v < first + count; v++)
+                    {
+                        const unsigned char *rgba = command.lineColors + 4 * v;
+                        rlColor4ub(rgba[0], rgba[1], rgba[2], rgba[3]);
+                        rlVertex3f(command.lineVertices[3 * v], command.lineVertices[3 * v + 1], command.lineVertices[3 * v + 2]);
+                    }
+                    rlEnd();
+                }
+                break;
+        }
+    }
+    if (inWorld)
+    {
+        EndMode3D();
+    }
+    EndBlendMode();
+
+    // [----------------- END DRAWING -----------------]
+    EndDrawing();
+}
@@ -0,0 +1,59 @@
+/**
+ * raylib front end - owns the window and the textures, records each frame
+ * with recordScene() and submits the sorted command list to raylib.
+*/
+
+#ifndef GGJ24_RAYLIB_BACKEND_H
+#define GGJ24_RAYLIB_BACKEND_H
+
+#include "animated_texture.h"
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "backend.h"
+#include "render_list.h"
+#include "scene.h"
+#include "texture_cache.h"
+
+#include <memory>
+#include <vector>
+
+class RaylibBackend : public Backend
+{
+public:
+    RaylibBackend();
+    ~RaylibBackend() override;
+
+    bool shouldClose() override;
+    float frameTime() override;
+    SimInputs pollInputs(const SimSnapshot &snapshot) override;
+    void present(const SimSnapshot &snapshot, float alpha) override;
+
+private:
+    // Uploads every atlas page from the pre-decoded pack, false if it is missing or stale
+    bool loadAtlasPack();
+    // Hands the uploaded atlas pages to the scene
+    void finishLoading();
+    // Draws a sorted list with raylib
+    void submit(const RenderList &list);
+    // (Re)uploads the baked arena triangles when they were rebaked
+    void uploadArena();
+
+    // Declared before the handles and the loader so it outlives them
+    TextureCache textures;
+    std::vector<TextureHandle> atlasTextures;
+    // Only while the start screen loads, null after finishLoading()
+    std::unique_ptr<AssetLoader> loader;
+    SceneAssets assets;
+    // Streams the menu banner, only advanced while a menu is up
+    std::unique_ptr<AnimatedTexture> banner;
+    // Instanced draws - one mesh per RenderMesh, all sharing the instancing shader
+    Shader instancingShader{};
+    Material instancingMaterial{};
+    Material defaultMaterial{};
+    Mesh meshes[MESH_COUNT]{};
+    int uploadedArenaRevision{-1};
+    SceneDebug debug;
+    RenderList renderList;
+};
+
+#endif //GGJ24_RAYLIB_BACKEND_H
@@ -0,0 +1,252 @@
+#include "render_list.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Untextured shapes draw with rlgl's default texture, rectangles and text with
+// the default font atlas - stand-in ids for both so they sort apart from real textures
+constexpr unsigned int shapesTexture{0};
+constexpr unsigned int fontTexture{0xFFFFFFFFu};
+// Vertices per instance of each RenderMesh (GenMeshCube has 4 per face)
+constexpr int meshVertexCount[MESH_COUNT]{24, 0};
+
+// rlgl primitive mode each command is drawn with, anything that changes it starts a new draw call
+enum GpuMode
+{
+    GPU_LINES,
+    GPU_TRIANGLES,
+    GPU_QUADS
+};
+
+static GpuMode gpuModeOf(RenderPrimitive primitive)
+{
+    switch (primitive)
+    {
+        case PRIM_CUBE:
+            return GPU_TRIANGLES;
+        case PRIM_CUBE_WIRES:
+        case PRIM_LINES:
+            return GPU_LINES;
+        default:
+            return GPU_QUADS;
+    }
+}
+
+static int vertexCountOf(const RenderCommand &command, const char *text)
+{
+    switch (command.primitive)
+    {
+        case PRIM_CUBE:
+            return 36;
+        case PRIM_CUBE_WIRES:
+            return 24;
+        case PRIM_MESH_INSTANCES:
+            return meshVertexCount[command.mesh] * command.instanceCount;
+        case PRIM_MESH:
+        case PRIM_LINES:
+            return command.vertexCount;
+        case PRIM_TEXT:
+        {
+            // One quad per visible glyph
+            int glyphs = 0;
+            for (const char *c = text; *c; c++)
+            {
+                glyphs += (*c != ' ' && *c != '\n') ? 1 : 0;
+            }
+            return 4 * glyphs;
+        }
+        default:
+            return 4;
+    }
+}
+
+void RenderList::begin(Color clearColor, const Camera &camera)
+{
+    recorded.clear();
+    textArena.clear();
+    instanceArena.clear();
+    clear = clearColor;
+    view = camera;
+    pass = PASS_WORLD;
+    layer = 0;
+    blendMode = BLEND_ALPHA;
+    frameStats = {};
+}
+
+void RenderList::setPass(RenderPass renderPass, int renderLayer)
+{
+    pass = renderPass;
+    layer = renderLayer;
+}
+
+void RenderList::setBlendMode(int mode)
+{
+    blendMode = mode;
+}
+
+RenderCommand &RenderList::push(RenderPrimitive primitive, unsigned int textureId)
+{
+    RenderCommand &command = recorded.emplace_back();
+    command.key = static_cast<unsigned long long>(pass) << 60 |
+                  static_cast<unsigned long long>(layer & 0xFF) << 52 |
+                  static_cast<unsigned long long>(blendMode & 0xF) << 48 |
+                  static_cast<unsigned long long>(textureId) << 16 |
+                  static_cast<unsigned long long>(primitive);
+    command.primitive = primitive;
+    return command;
+}
+
+void RenderList::cube(Vector3 position, Vector3 size, Color color)
+{
+    RenderCommand &command = push(PRIM_CUBE, shapesTexture);
+    command.position = position;
+    command.size = size;
+    command.color = color;
+}
+
+void RenderList::cubeWires(Vector3 position, Vector3 size, Color color)
+{
+    RenderCommand &command = push(PRIM_CUBE_WIRES, shapesTexture);
+    command.position = position;
+    command.size = size;
+    command.color = color;
+}
+
+void RenderList::plane(Vector3 centre, Vector2 size, Color color)
+{
+    RenderCommand &command = push(PRIM_PLANE, shapesTexture);
+    command.position = centre;
+    command.size = {size.x, 0.f, size.y};
+    command.color = color;
+}
+
+void RenderList::billboard(Texture2D texture, Rectangle source, Vector3 position, Vector2 size, Color color)
+{
+    RenderCommand &command = push(PRIM_BILLBOARD, texture.id);
+    command.texture = texture;
+    command.source = source;
+    command.position = position;
+    command.size = {size.x, size.y, 0.f};
+    command.color = color;
+}
+
+void RenderList::texture(Texture2D texture, Rectangle source, Vector2 position, float scale, Color color)
+{
+    RenderCommand &command = push(PRIM_TEXTURE, texture.id);
+    command.texture = texture;
+    command.source = source;
+    command.position = {position.x, position.y, 0.f};
+    command.size = {scale, scale, 0.f};
+    command.color = color;
+}
+
+void RenderList::rectangle(int x, int y, int width, int height, Color color)
+{
+    RenderCommand &command = push(PRIM_RECTANGLE, fontTexture);
+    command.source = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(width), static_cast<float>(height)};
+    command.color = color;
+}
+
+void RenderList::text(const char *text, int x, int y, int fontSize, Color color)
+{
+    RenderCommand &command = push(PRIM_TEXT, fontTexture);
+    command.position = {static_cast<float>(x), static_cast<float>(y), 0.f};
+    command.color = color;
+    command.fontSize = fontSize;
+    command.centred = false;
+    command.textOffset = static_cast<int>(textArena.size());
+    textArena.append(text, strlen(text) + 1);
+}
+
+void RenderList::centredText(const char *text, int centreX, int y, int fontSize, Color color)
+{
+    this->text(text, centreX, y, fontSize, color);
+    recorded.back().centred = true;
+}
+
+Matrix *RenderList::meshInstances(RenderMesh mesh, int count, Color color)
+{
+    if (count <= 0)
+    {
+        return nullptr;
+    }
+    RenderCommand &command = push(PRIM_MESH_INSTANCES, shapesTexture);
+    command.mesh = mesh;
+    command.color = color;
+    command.instanceOffset = static_cast<int>(instanceArena.size());
+    command.instanceCount = count;
+    instanceArena.resize(instanceArena.size() + count);
+    return instanceArena.data() + command.instanceOffset;
+}
+
+void RenderList::mesh(RenderMesh mesh, int vertexCount, Color tint)
+{
+    if (vertexCount <= 0)
+    {
+        return;
+    }
+    RenderCommand &command = push(PRIM_MESH, shapesTexture);
+    command.mesh = mesh;
+    command.vertexCount = vertexCount;
+    command.color = tint;
+}
+
+void RenderList::lines(const float *vertices, const unsigned char *colors, int vertexCount)
+{
+    if (vertexCount <= 0)
+    {
+        return;
+    }
+    RenderCommand &command = push(PRIM_LINES, shapesTexture);
+    command.lineVertices = vertices;
+    command.lineColors = colors;
+    command.vertexCount = vertexCount;
+}
+
+void RenderList::sort()
+{
+    std::stable_sort(recorded.begin(), recorded.end(), [](const RenderCommand &a, const RenderCommand &b)
+    {
+        return a.key < b.key;
+    });
+
+    // Walk the list the way rlgl will batch it: a new draw call whenever the
+    // pass, blend mode, texture or primitive mode changes, or the batch fills
+    frameStats = {};
+    frameStats.commands = static_cast<int>(recorded.size());
+    unsigned long long lastState = 0;
+    GpuMode lastMode = GPU_LINES;
+    int callVertices = 0;
+    bool inCall = false;
+    for (const RenderCommand &command : recorded)
+    {
+        if (command.primitive == PRIM_MESH_INSTANCES || command.primitive == PRIM_MESH)
+        {
+            // Drawn straight away by raylib, outside the immediate-mode batch
+            frameStats.drawCalls++;
+            frameStats.vertices += vertexCountOf(command, nullptr);
+            frameStats.instances += command.primitive == PRIM_MESH_INSTANCES ? command.instanceCount : 0;
+            continue;
+        }
+        // Everything but the layer and the primitive is state rlgl cares about
+        unsigned long long state = command.key & ~(0xFFull << 52) & ~0xFFFFull;
+        GpuMode mode = gpuModeOf(command.primitive);
+        int vertices = vertexCountOf(command, command.primitive == PRIM_TEXT ? textOf(command) : nullptr);
+        if (!inCall || state != lastState || mode != lastMode || callVertices + vertices > batchVertexLimit)
+        {
+            frameStats.drawCalls++;
+            callVertices = 0;
+            inCall = true;
+        }
+        callVertices += vertices;
+        // Long line lists are pushed in pieces, each full batch is another call
+        while (callVertices > batchVertexLimit)
+        {
+            frameStats.drawCalls++;
+            callVertices -= batchVertexLimit;
+        }
+        frameStats.vertices += vertices;
+        lastState = state;
+        lastMode = mode;
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ * Render command list. A frame is recorded as plain commands first (no GL
+ * calls, so it works headless), then sorted by pass, layer, blend mode,
+ * texture and primitive so raylib's batcher sees as few state changes as
+ * possible, and finally submitted by the front end. sort() also counts the
+ * draw calls and vertices the submit will cost, following rlgl's batching.
+ * Crowds of identical meshes go in as one instanced draw with a transform
+ * per instance instead of a command each.
+*/
+
+#ifndef GGJ24_RENDER_LIST_H
+#define GGJ24_RENDER_LIST_H
+
+#include "raylib.h"
+
+#include <string>
+#include <vector>
+
+// World is drawn inside BeginMode3D(camera), Screen on top of it in 2D
+enum RenderPass
+{
+    PASS_WORLD,
+    PASS_SCREEN
+};
+
+enum RenderPrimitive
+{
+    PRIM_CUBE,          // DrawCubeV
+    PRIM_CUBE_WIRES,    // DrawCubeWiresV
+    PRIM_PLANE,         // DrawPlane
+    PRIM_BILLBOARD,     // DrawBillboardPro, up {0, 1, 0}, no origin or rotation
+    PRIM_TEXTURE,       // DrawTextureEx, no rotation
+    PRIM_RECTANGLE,     // DrawRectangle
+    PRIM_TEXT,          // DrawText, optionally centred on position.x
+    PRIM_MESH_INSTANCES,// DrawMeshInstanced, one draw call for every instance
+    PRIM_MESH,          // DrawMesh at the origin, one draw call
+    PRIM_LINES          // Prebuilt line list pushed through rlgl in one go
+};
+
+// Meshes the front end keeps uploaded for instanced draws
+enum RenderMesh
+{
+    MESH_PROJECTILE,    // 0.2 cube for pies and shots
+    MESH_ARENA,         // ArenaMesh triangles
+    MESH_COUNT
+};
+
+struct RenderCommand
+{
+    unsigned long long key;     // pass | layer | blend | texture | primitive
+    RenderPrimitive primitive;
+    Texture2D texture;
+    Rectangle source;           // billboard / texture source, or x/y/width/height of a rectangle
+    Vector3 position;
+    Vector3 size;               // cube size, plane x/z, billboard x/y, texture scale in x
+    Color color;
+    int textOffset;             // into the text arena, for PRIM_TEXT
+    int fontSize;
+    bool centred;
+    RenderMesh mesh;            // PRIM_MESH_INSTANCES and PRIM_MESH, drawn tinted by color
+    int instanceOffset;         // into the instance arena
+    int instanceCount;
+    int vertexCount;            // PRIM_MESH and PRIM_LINES
+    const float *lineVertices;  // PRIM_LINES, xyz and rgba per vertex, owned by the caller
+    const unsigned char *lineColors;
+};
+
+// rlgl flushes a batch once it holds RL_DEFAULT_BATCH_BUFFER_ELEMENTS quads
+constexpr int batchVertexLimit{8192 * 4};
+
+struct RenderStats
+{
+    int commands{0};
+    int drawCalls{0};
+    int vertices{0};
+    int instances{0};
+};
+
+class RenderList
+{
+public:
+    // Starts a new frame, drops last frame's commands but keeps their memory
+    void begin(Color clearColor, const Camera &camera);
+    // Commands recorded after this go into pass, drawn in layer order within
+    // it. Order between commands of the same layer is not kept
+    void setPass(RenderPass pass, int layer = 0);
+    void setBlendMode(int blendMode);
+
+    // [-------------- RECORDING -----------------------]
+    void cube(Vector3 position, Vector3 size, Color color);
+    void cubeWires(Vector3 position, Vector3 size, Color color);
+    void plane(Vector3 centre, Vector2 size, Color color);
+    void billboard(Texture2D texture, Rectangle source, Vector3 position, Vector2 size, Color color);
+    // source out of texture, drawn scale times its size with its top left at position
+    void texture(Texture2D texture, Rectangle source, Vector2 position, float scale, Color color);
+    void rectangle(int x, int y, int width, int height, Color color);
+    void text(const char *text, int x, int y, int fontSize, Color color);
+    // Text centred horizontally on centreX
+    void centredText(const char *text, int centreX, int y, int fontSize, Color color);
+    // Reserves count instance transforms for one instanced draw of mesh and
+    // returns them to be filled in. The pointer is only good until the next
+    // recording call. Nothing is recorded for count 0
+    Matrix *meshInstances(RenderMesh mesh, int count, Color color);
+    // A prebuilt mesh of vertexCount vertices, drawn untransformed
+    void mesh(RenderMesh mesh, int vertexCount, Color tint);
+    // vertexCount / 2 coloured lines, the arrays must live until the list is submitted
+    void lines(const float *vertices, const unsigned char *colors, int vertexCount);
+
+    // Sorts the commands into submit order and counts what they cost
+    void sort();
+
+    const std::vector<RenderCommand> &commands() const { return recorded; }
+    const char *textOf(const RenderCommand &command) const { return textArena.data() + command.textOffset; }
+    const Matrix *instancesOf(const RenderCommand &command) const { return instanceArena.data() + command.instanceOffset; }
+    RenderPass passOf(const RenderCommand &command) const { return static_cast<RenderPass>(command.key >> 60); }
+    int blendModeOf(const RenderCommand &command) const { return static_cast<int>((command.key >> 48) & 0xF); }
+    Color clearColor() const { return clear; }
+    const Camera &camera() const { return view; }
+    // Valid after sort()
+    RenderStats stats() const { return frameStats; }
+
+private:
+    RenderCommand &push(RenderPrimitive primitive, unsigned int textureId);
+
+    std::vector<RenderCommand> recorded;
+    std::string textArena;
+    std::vector<Matrix> instanceArena;
+    Color clear{};
+    Camera view{};
+    RenderPass pass{PASS_WORLD};
+    int layer{0};
+    int blendMode{BLEND_ALPHA};
+    RenderStats frameStats;
+};
+
+#endif //GGJ24_RENDER_LIST_H
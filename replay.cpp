@@ -0,0 +1,343 @@
+#include "replay.h"
+
+#include <cstring>
+
+static const char replayMagic[8] = {'G', 'G', 'J', '2', '4', 'R', 'P', '\0'};
+
+// What changed in a record, and the record that ends the file. A record
+// that changes nothing is only the run before it, written at a flush
+constexpr int changedBits{1};
+constexpr int changedMouseX{2};
+constexpr int changedMouseY{4};
+constexpr int endOfReplay{0x80};
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint16_t packInputs(const SimInputs &inputs)
+{
+    const bool flags[] = {inputs.moveForward, inputs.moveBack, inputs.moveLeft, inputs.moveRight,
+                          inputs.sprint, inputs.crouch, inputs.crouchReleased, inputs.jump,
+                          inputs.fire, inputs.start, inputs.restart, inputs.anyKeyPressed};
+    uint16_t bits = 0;
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+    {
+        bits |= static_cast<uint16_t>(flags[i] ? 1u << i : 0u);
+    }
+    return bits;
+}
+
+SimInputs unpackInputs(uint16_t bits, Vector2 mouseDelta)
+{
+    SimInputs inputs;
+    bool *flags[] = {&inputs.moveForward, &inputs.moveBack, &inputs.moveLeft, &inputs.moveRight,
+                     &inputs.sprint, &inputs.crouch, &inputs.crouchReleased, &inputs.jump,
+                     &inputs.fire, &inputs.start, &inputs.restart, &inputs.anyKeyPressed};
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+    {
+        *flags[i] = (bits & (1u << i)) != 0;
+    }
+    inputs.mouseDelta = mouseDelta;
+    return inputs;
+}
+
+// [-------------- WRITER -----------------------]
+
+ReplayWriter::~ReplayWriter()
+{
+    if (file != nullptr)
+    {
+        // Left as a file cut short, it still plays up to the last record
+        fclose(file);
+    }
+}
+
+bool ReplayWriter::open(const char *path, const SimConfig &config)
+{
+    file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    ReplayHeader header{};
+    memcpy(header.magic, replayMagic, sizeof(header.magic));
+    header.version = replayVersion;
+    header.seed = config.seed;
+    header.tickRate = config.tickRate;
+    header.crowd = config.crowd;
+    flushTicks = config.tickRate;
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+void ReplayWriter::writeVarint(uint64_t value)
+{
+    // LEB128 - seven bits a byte, the top bit set on all but the last
+    unsigned char bytes[10];
+    int count = 0;
+    do
+    {
+        bytes[count] = static_cast<unsigned char>(value & 0x7F);
+        value >>= 7;
+        if (value != 0)
+        {
+            bytes[count] |= 0x80;
+        }
+        count++;
+    } while (value != 0);
+    fwrite(bytes, 1, count, file);
+}
+
+void ReplayWriter::writeRecord(int mask, uint16_t bits, uint32_t mouseX, uint32_t mouseY)
+{
+    writeVarint(unchanged);
+    fputc(mask, file);
+    if ((mask & changedBits) != 0)
+    {
+        writeVarint(bits ^ lastBits);
+    }
+    if ((mask & changedMouseX) != 0)
+    {
+        writeVarint(mouseX ^ lastMouseX);
+    }
+    if ((mask & changedMouseY) != 0)
+    {
+        writeVarint(mouseY ^ lastMouseY);
+    }
+    unchanged = 0;
+}
+
+void ReplayWriter::record(const SimInputs &inputs)
+{
+    if (file == nullptr)
+    {
+        return;
+    }
+    recorded++;
+    uint16_t bits = packInputs(inputs);
+    uint32_t mouseX = floatBits(inputs.mouseDelta.x);
+    uint32_t mouseY = floatBits(inputs.mouseDelta.y);
+    int mask = (bits != lastBits ? changedBits : 0) | (mouseX != lastMouseX ? changedMouseX : 0) |
+               (mouseY != lastMouseY ? changedMouseY : 0);
+    if (mask == 0)
+    {
+        unchanged++;
+    }
+    else
+    {
+        writeRecord(mask, bits, mouseX, mouseY);
+        lastBits = bits;
+        lastMouseX = mouseX;
+        lastMouseY = mouseY;
+    }
+
+    // A session that dies loses at most the ticks since the last flush
+    if (recorded % flushTicks == 0)
+    {
+        if (unchanged > 0)
+        {
+            writeRecord(0, lastBits, lastMouseX, lastMouseY);
+        }
+        fflush(file);
+    }
+}
+
+bool ReplayWriter::finish(uint64_t checksum)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+    writeRecord(endOfReplay, lastBits, lastMouseX, lastMouseY);
+    writeVarint(static_cast<uint64_t>(recorded));
+    bool written = fwrite(&checksum, sizeof(checksum), 1, file) == 1;
+    written = fclose(file) == 0 && written;
+    file = nullptr;
+    return written;
+}
+
+// [-------------- READER -----------------------]
+
+ReplayReader::~ReplayReader()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+}
+
+bool ReplayReader::fail(const char *message)
+{
+    lastError = message;
+    ended = true;
+    return false;
+}
+
+bool ReplayReader::open(const char *path)
+{
+    file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return fail("can't open file");
+    }
+    if (fread(&header, sizeof(header), 1, file) != 1)
+    {
+        return fail("truncated header");
+    }
+    if (memcmp(header.magic, replayMagic, sizeof(replayMagic)) != 0)
+    {
+        return fail("not a replay");
+    }
+    if (header.version != replayVersion)
+    {
+        return fail("replay from another version");
+    }
+    if (header.tickRate != 60 && header.tickRate != 120 && header.tickRate != 240)
+    {
+        return fail("bad tick rate");
+    }
+    return true;
+}
+
+SimConfig ReplayReader::config() const
+{
+    SimConfig config;
+    config.seed = header.seed;
+    config.tickRate = header.tickRate;
+    config.crowd = header.crowd;
+    return config;
+}
+
+bool ReplayReader::readVarint(uint64_t *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = fgetc(file);
+        if (byte == EOF)
+        {
+            return false;
+        }
+        *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReplayReader::readRecord()
+{
+    // A file that stops at a record boundary (or inside one) is a session
+    // that was cut short - it ends there, without a checksum
+    uint64_t count;
+    if (!readVarint(&count))
+    {
+        ended = true;
+        return true;
+    }
+    // The unchanged run before a change is written whole, so it happened
+    repeats = count;
+    int mask = fgetc(file);
+    if (mask == EOF)
+    {
+        ended = true;
+        return true;
+    }
+    if (mask == endOfReplay)
+    {
+        uint64_t ticks;
+        if (!readVarint(&ticks) || fread(&trailerChecksum, sizeof(trailerChecksum), 1, file) != 1)
+        {
+            return fail("truncated ending");
+        }
+        trailerTicks = static_cast<long long>(ticks);
+        hasTrailer = true;
+        ended = true;
+        return true;
+    }
+    if ((mask & ~(changedBits | changedMouseX | changedMouseY)) != 0)
+    {
+        return fail("bad record");
+    }
+    if (mask == 0)
+    {
+        // Only a run, flushed before anything changed
+        return true;
+    }
+
+    uint64_t deltas[3] = {0, 0, 0};
+    const uint64_t limits[3] = {0xFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+    for (int field = 0; field < 3; field++)
+    {
+        if ((mask & (1 << field)) == 0)
+        {
+            continue;
+        }
+        if (!readVarint(&deltas[field]))
+        {
+            // Cut short in the middle of the change, only the run before it counts
+            ended = true;
+            return true;
+        }
+        if (deltas[field] > limits[field])
+        {
+            return fail("bad record");
+        }
+    }
+    decodedBits ^= static_cast<uint16_t>(deltas[0]);
+    decodedMouseX ^= static_cast<uint32_t>(deltas[1]);
+    decodedMouseY ^= static_cast<uint32_t>(deltas[2]);
+    changePending = true;
+    return true;
+}
+
+bool ReplayReader::next(SimInputs &inputs)
+{
+    // The unchanged ticks play out on the inputs from before the change
+    while (repeats == 0 && !changePending)
+    {
+        if (ended || file == nullptr || !readRecord())
+        {
+            return false;
+        }
+    }
+    if (repeats > 0)
+    {
+        repeats--;
+    }
+    else
+    {
+        changePending = false;
+        bits = decodedBits;
+        mouseX = decodedMouseX;
+        mouseY = decodedMouseY;
+    }
+    inputs = unpackInputs(bits, {bitsFloat(mouseX), bitsFloat(mouseY)});
+    played++;
+    return true;
+}
+
+long long runReplay(Sim &sim, ReplayReader &replay)
+{
+    const float tickSeconds = sim.tickSeconds();
+    SimInputs inputs;
+    long long ticks = 0;
+    while (replay.next(inputs))
+    {
+        sim.step(inputs, tickSeconds);
+        ticks++;
+    }
+    return ticks;
+}
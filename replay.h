@@ -0,0 +1,119 @@
+/**
+ * Input recording and replay. The sim is deterministic from its config and
+ * the SimInputs of every tick, so that is all a replay holds: a header with
+ * the seed, tick rate and crowd, then each tick's inputs as a bitset and the
+ * mouse delta. Ticks are delta-encoded against the one before - a run of
+ * unchanged ticks is one count, a change is the XOR of the bits and of the
+ * mouse floats' bit patterns, as varints. Once a second of ticks the run so
+ * far is written out and the file flushed, so a session that dies replays up
+ * to the last flush before it. A finished file ends with the tick count and
+ * Sim::checksum(), which replays check themselves against.
+*/
+
+#ifndef GGJ24_REPLAY_H
+#define GGJ24_REPLAY_H
+
+#include "sim.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Bump whenever the layout below changes, old replays are then rejected
+constexpr uint32_t replayVersion{1};
+
+struct ReplayHeader
+{
+    char magic[8];              // "GGJ24RP\0"
+    uint32_t version;
+    uint32_t seed;
+    int32_t tickRate;
+    int32_t crowd;
+};
+
+// One bit per SimInputs flag, in declaration order
+uint16_t packInputs(const SimInputs &inputs);
+SimInputs unpackInputs(uint16_t bits, Vector2 mouseDelta);
+
+class ReplayWriter
+{
+public:
+    ReplayWriter() = default;
+    ReplayWriter(const ReplayWriter &) = delete;
+    ReplayWriter &operator=(const ReplayWriter &) = delete;
+    // Closes without a checksum if finish() was never called
+    ~ReplayWriter();
+
+    bool open(const char *path, const SimConfig &config);
+    // The inputs of one tick, in tick order. Flushes every flushTicks of them
+    void record(const SimInputs &inputs);
+    // Ends the file with the sim's state after the last recorded tick
+    bool finish(uint64_t checksum);
+
+    long long ticks() const { return recorded; }
+
+private:
+    void writeVarint(uint64_t value);
+    // Writes the run of unchanged ticks so far and the change after it
+    void writeRecord(int mask, uint16_t bits, uint32_t mouseX, uint32_t mouseY);
+
+    FILE *file{nullptr};
+    long long flushTicks{60};
+    long long recorded{0};
+    long long unchanged{0};
+    uint16_t lastBits{0};
+    uint32_t lastMouseX{0};
+    uint32_t lastMouseY{0};
+};
+
+class ReplayReader
+{
+public:
+    ReplayReader() = default;
+    ReplayReader(const ReplayReader &) = delete;
+    ReplayReader &operator=(const ReplayReader &) = delete;
+    ~ReplayReader();
+
+    // Reads the header, false (see error()) if path is not a replay this build can play
+    bool open(const char *path);
+    // The config the session was recorded with, workers left at the default
+    SimConfig config() const;
+
+    // The next tick's inputs, false at the end of the file or a broken one (error() is set then)
+    bool next(SimInputs &inputs);
+    long long ticks() const { return played; }
+    // Once next() has returned false: whether the file was finished, and its ending
+    bool finished() const { return hasTrailer; }
+    long long recordedTicks() const { return trailerTicks; }
+    uint64_t recordedChecksum() const { return trailerChecksum; }
+    const char *error() const { return lastError.c_str(); }
+
+private:
+    bool fail(const char *message);
+    bool readVarint(uint64_t *value);
+    // Decodes the next record into a run of repeats and a pending change (or the end)
+    bool readRecord();
+
+    FILE *file{nullptr};
+    ReplayHeader header{};
+    std::string lastError;
+    long long played{0};
+    uint64_t repeats{0};
+    bool changePending{false};
+    bool ended{false};
+    // What ticks play now, and what they play once the pending change is reached
+    uint16_t bits{0};
+    uint32_t mouseX{0};
+    uint32_t mouseY{0};
+    uint16_t decodedBits{0};
+    uint32_t decodedMouseX{0};
+    uint32_t decodedMouseY{0};
+    bool hasTrailer{false};
+    long long trailerTicks{0};
+    uint64_t trailerChecksum{0};
+};
+
+// Steps sim through every tick of replay as fast as it goes, returns how many
+long long runReplay(Sim &sim, ReplayReader &replay);
+
+#endif //GGJ24_REPLAY_H
@@ -0,0 +1,147 @@
+#include "rng.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define GGJ24_SIMD_X86 1
+#endif
+
+// Philox4x32 round multipliers and key schedule (Salmon et al., Random123)
+constexpr uint32_t philoxM0{0xD2511F53u};
+constexpr uint32_t philoxM1{0xCD9E8D57u};
+constexpr uint32_t philoxW0{0x9E3779B9u};
+constexpr uint32_t philoxW1{0xBB67AE85u};
+constexpr int philoxRounds{10};
+// In-turn draws use this subject, entities never have it (Entity's invalid index)
+constexpr uint64_t inTurnSubject{~0ull};
+
+static uint64_t splitMix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static void philox(const uint32_t key[2], uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t out[4])
+{
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < philoxRounds; round++)
+    {
+        uint64_t p0 = static_cast<uint64_t>(philoxM0) * c0;
+        uint64_t p1 = static_cast<uint64_t>(philoxM1) * c2;
+        uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+        uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += philoxW0;
+        k1 += philoxW1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+RngStream::RngStream(uint64_t matchSeed, const char *name)
+{
+    // FNV-1a of the name, mixed with the seed so every stream of every match differs
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char *c = name; *c != '\0'; c++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 0x100000001B3ull;
+    }
+    uint64_t mixed = splitMix(matchSeed ^ splitMix(hash));
+    key[0] = static_cast<uint32_t>(mixed);
+    key[1] = static_cast<uint32_t>(mixed >> 32);
+}
+
+void RngStream::block(uint64_t subject, uint64_t sequence, uint32_t out[4]) const
+{
+    philox(key, static_cast<uint32_t>(sequence), static_cast<uint32_t>(sequence >> 32),
+           static_cast<uint32_t>(subject), static_cast<uint32_t>(subject >> 32), out);
+}
+
+uint32_t RngStream::next()
+{
+    if (used == 4)
+    {
+        block(inTurnSubject, position++, buffer);
+        used = 0;
+    }
+    return buffer[used++];
+}
+
+#ifdef GGJ24_SIMD_X86
+// Low and high halves of a * m for four lanes, SSE2 only multiplies two at a time
+static inline void mulHiLo(__m128i a, __m128i m, __m128i &hi, __m128i &lo)
+{
+    const __m128i lowLanes = _mm_set_epi32(0, -1, 0, -1);
+    __m128i even = _mm_mul_epu32(a, m);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    lo = _mm_or_si128(_mm_and_si128(even, lowLanes), _mm_slli_epi64(odd, 32));
+    hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lowLanes, odd));
+}
+
+// Blocks first .. first + 3 of the in-turn draws, one per lane, written out in order
+static void philox4(const uint32_t key[2], uint64_t first, uint32_t *out)
+{
+    __m128i c0 = _mm_set_epi32(static_cast<int>(first + 3), static_cast<int>(first + 2),
+                               static_cast<int>(first + 1), static_cast<int>(first));
+    __m128i c1 = _mm_set_epi32(static_cast<int>((first + 3) >> 32), static_cast<int>((first + 2) >> 32),
+                               static_cast<int>((first + 1) >> 32), static_cast<int>(first >> 32));
+    __m128i c2 = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(inTurnSubject)));
+    __m128i c3 = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(inTurnSubject >> 32)));
+    const __m128i m0 = _mm_set1_epi32(static_cast<int>(philoxM0));
+    const __m128i m1 = _mm_set1_epi32(static_cast<int>(philoxM1));
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < philoxRounds; round++)
+    {
+        __m128i hi0, lo0, hi1, lo1;
+        mulHiLo(c0, m0, hi0, lo0);
+        mulHiLo(c2, m1, hi1, lo1);
+        c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(static_cast<int>(k0)));
+        c1 = lo1;
+        c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(static_cast<int>(k1)));
+        c3 = lo0;
+        k0 += philoxW0;
+        k1 += philoxW1;
+    }
+    // Lane b of c0..c3 is block b, transpose so each block's words sit together
+    __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+    __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+    __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+    __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 12), _mm_unpackhi_epi64(t2, t3));
+}
+#endif
+
+void RngStream::fill(int lo, int hi, int count, int *out)
+{
+    uint32_t words[16];
+    int i = 0;
+#ifdef GGJ24_SIMD_X86
+    for (; i + 16 <= count; i += 16)
+    {
+        philox4(key, position, words);
+        position += 4;
+        for (int w = 0; w < 16; w++)
+        {
+            out[i + w] = toInt(words[w], lo, hi);
+        }
+    }
+#endif
+    for (; i < count; i += 4)
+    {
+        block(inTurnSubject, position++, words);
+        for (int w = 0; w < 4 && i + w < count; w++)
+        {
+            out[i + w] = toInt(words[w], lo, hi);
+        }
+    }
+    used = 4;
+}
@@ -0,0 +1,52 @@
+/**
+ * Counter-based random numbers (Philox4x32-10). A draw is a pure function of
+ * a key and a counter - no state carried from one draw to the next - so the
+ * same draw comes out whichever thread makes it and in whatever order. Each
+ * system gets a named stream, its key hashed from the match seed and the
+ * name, so streams never overlap and adding one doesn't shift the others.
+ * Draws are either keyed by a subject (an entity) and a sequence number (a
+ * tick), for work split over threads, or taken in turn for one-off setup,
+ * with fill() generating runs of them four blocks at a time in SSE2.
+*/
+
+#ifndef GGJ24_RNG_H
+#define GGJ24_RNG_H
+
+#include <cstdint>
+
+class RngStream
+{
+public:
+    RngStream(uint64_t matchSeed, const char *name);
+
+    // [-------------- KEYED -----------------------]
+    // Four words for subject at sequence, the same every time they are asked for
+    void block(uint64_t subject, uint64_t sequence, uint32_t out[4]) const;
+
+    // [-------------- IN TURN -----------------------]
+    uint32_t next();
+    // Uniform in [lo, hi]
+    int nextInt(int lo, int hi) { return toInt(next(), lo, hi); }
+    // count ints in [lo, hi] from whole blocks - what is left of the current
+    // block is skipped, otherwise the same as that many nextInt()s
+    void fill(int lo, int hi, int count, int *out);
+
+    // [-------------- MAPPING -----------------------]
+    // Multiply-shift onto [lo, hi], biased by at most (hi - lo + 1) / 2^32
+    static int toInt(uint32_t word, int lo, int hi)
+    {
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo + 1);
+        return static_cast<int>(lo + static_cast<int64_t>((word * range) >> 32));
+    }
+    // Uniform in [0, 1), 24 bits of the word
+    static float toUnit(uint32_t word) { return static_cast<float>(word >> 8) * (1.f / 16777216.f); }
+
+private:
+    uint32_t key[2];
+    // Next block of the in-turn draws, and how much of the current one is used
+    uint64_t position{0};
+    uint32_t buffer[4]{};
+    int used{4};
+};
+
+#endif //GGJ24_RNG_H
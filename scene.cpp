@@ -0,0 +1,298 @@
+#include "scene.h"
+
+#include "raymath.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+// printf into a scratch buffer, stands in for raylib's TextFormat()
+static const char *format(const char *text, ...)
+{
+    static char buffer[256];
+    va_list args;
+    va_start(args, text);
+    vsnprintf(buffer, sizeof(buffer), text, args);
+    va_end(args);
+    return buffer;
+}
+
+// Same as raylib's Fade()
+static Color fade(Color color, float alpha)
+{
+    color.a = static_cast<unsigned char>(255.f * alpha);
+    return color;
+}
+
+// Projectiles are 0.2 cubes, this sphere holds one
+constexpr float projectileCullRadius{0.18f};
+// Billboards are 1x1 quads around their position
+constexpr float billboardCullRadius{0.71f};
+
+// The menu banner is scaled to this height, whatever size the GIF is
+constexpr float bannerHeight{240.f};
+
+// Culls count projectiles, placed by positionOf(i), and records the survivors
+// as one instanced draw of translation-only transforms
+template<typename Position>
+static void recordProjectiles(int count, Position &&positionOf, Color color, FrustumCuller &culler, RenderList &list)
+{
+    culler.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        Vector3 position = positionOf(i);
+        culler.x[i] = position.x;
+        culler.y[i] = position.y;
+        culler.z[i] = position.z;
+    }
+    int visible = culler.cullSpheres(culler.x.data(), culler.y.data(), culler.z.data(), projectileCullRadius, count, culler.visible.data());
+
+    Matrix *instances = list.meshInstances(MESH_PROJECTILE, visible, color);
+    for (int v = 0; v < visible; v++)
+    {
+        int i = culler.visible[v];
+        instances[v] = MatrixTranslate(culler.x[i], culler.y[i], culler.z[i]);
+    }
+}
+
+// Column outlines for the columns in view. The solid columns stay in the one
+// baked mesh - splitting it per column would cost a draw call each
+static void recordColumnOutlines(const SimSnapshot &sim, const ArenaMesh &arena, FrustumCuller &culler, RenderList &list)
+{
+    culler.reserve(MAX_COLUMNS);
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        culler.x[i] = sim.positions[i].x;
+        culler.y[i] = sim.positions[i].y;
+        culler.z[i] = sim.positions[i].z;
+        culler.ex[i] = 1.f;
+        culler.ey[i] = sim.heights[i] / 2.f;
+        culler.ez[i] = 1.f;
+    }
+    int visible = culler.cullBoxes(culler.x.data(), culler.y.data(), culler.z.data(),
+                                   culler.ex.data(), culler.ey.data(), culler.ez.data(), MAX_COLUMNS, culler.visible.data());
+    for (int v = 0; v < visible; v++)
+    {
+        int first = culler.visible[v] * ArenaMesh::boxLineVertices;
+        // Same state for all of them, rlgl still draws them in one call
+        list.lines(arena.lineVertices().data() + 3 * first, arena.lineColors().data() + 4 * first, ArenaMesh::boxLineVertices);
+    }
+}
+
+// Every sprite entity as a billboard at its interpolated position, culled in one batch
+static void recordSprites(const SimSnapshot &sim, float alpha, const SceneAssets &assets, FrustumCuller &culler, RenderList &list)
+{
+    int count = static_cast<int>(sim.sprites.size());
+    culler.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        Vector3 position = sim.spritePosition(i, alpha);
+        culler.x[i] = position.x;
+        culler.y[i] = position.y;
+        culler.z[i] = position.z;
+    }
+    int visible = culler.cullSpheres(culler.x.data(), culler.y.data(), culler.z.data(), billboardCullRadius, count, culler.visible.data());
+    for (int v = 0; v < visible; v++)
+    {
+        int i = culler.visible[v];
+        const SpriteSnapshot &sprite = sim.sprites[i];
+        SpriteFrame frame = spriteFrame(assets, sprite.sprite, sprite.frame);
+        list.billboard(frame.texture, frame.rec, {culler.x[i], culler.y[i], culler.z[i]}, {1.0f, 1.0f}, WHITE);
+    }
+}
+
+static void recordPlaying(const SimSnapshot &sim, float alpha, SceneAssets &assets, const SceneDebug &debug, RenderList &list)
+{
+    const RenderState view = sim.view(alpha);
+    const Camera &cam = view.cam;
+
+    list.begin(WHITE, cam);
+    FrustumCuller &culler = assets.culler;
+    culler.begin(cam, static_cast<float>(Sim::screenWidth) / Sim::screenHeight);
+    list.setPass(PASS_WORLD);
+    list.setBlendMode(BLEND_ALPHA);
+
+    // [---------------- DRAW ENVIRONMENT ----------------------]
+    // Ground plane, walls and columns never move - one baked mesh and the
+    // column outlines, however many columns there are
+    assets.arena.bake(sim);
+    list.mesh(MESH_ARENA, assets.arena.triangleVertexCount(), WHITE);
+    recordColumnOutlines(sim, assets.arena, culler, list);
+
+    // [---------------- DRAW PROJECTILE ----------------------]
+    // One instanced draw per projectile type, only what the camera can see
+    // [----------- PIE PROJECTILE ---------------]
+    recordProjectiles(static_cast<int>(sim.pies.size()), [&](int i) { return sim.piePosition(i, alpha); }, GREEN, culler, list);
+    // [----------------- PLAYER PROJECTILE -----------------]
+    recordProjectiles(static_cast<int>(sim.shots.size()), [&](int i) { return sim.shotPosition(i, alpha); }, PINK, culler, list);
+
+    // DEBUG RECT - drawn in world space like it always was
+    list.rectangle(600, 5, 330, 150, fade(SKYBLUE, 0.5f));
+
+    // Hand cube
+    list.cube(view.handPosition, (Vector3){0.2f, 0.2f, 0.2f}, PINK);
+    list.cubeWires(view.handPosition, (Vector3){0.2f, 0.2f, 0.2f}, BLACK);
+
+    // Billboards have see-through pixels, draw them over the solid geometry
+    list.setPass(PASS_WORLD, 1);
+
+    // [---------------- DRAW CLOWNYBARAS + GRUMULUMS ----------------------]
+    recordSprites(sim, alpha, assets, culler, list);
+
+    // [----------------- DRAW GRUM HEARTS ------------------]
+    Vector3 grumHeartOffset = {spriteFrame(assets, SPRITE_FULL_HEART).rec.width * 5.0f + 5, 0, 0};
+    int grumTempHealth = static_cast<int>(sim.grumHealth);
+    for (auto &heart : assets.grumHearts)
+    {
+        if (grumTempHealth > 0)
+        {
+            heart.isFull = true;
+            grumTempHealth--;
+        }
+        else
+        {
+            heart.isFull = false;
+        }
+        const SpriteFrame &grumHeart = heart.isFull ? heart.full : heart.empty;
+        if (culler.sphereVisible(assets.grumHeartsPos, billboardCullRadius))
+        {
+            list.billboard(grumHeart.texture, grumHeart.rec, assets.grumHeartsPos, {1.f, 1.f}, RAYWHITE);
+        }
+        assets.grumHeartsPos.z += grumHeartOffset.z;
+    }
+
+    // [---------------- DRAW HEART UI -----------------]
+    list.setPass(PASS_SCREEN);
+    Vector2 heartUIOffset = {spriteFrame(assets, SPRITE_FULL_HEART).rec.width * 5.0f + 5, 0};
+    int tempHealthVar = sim.health;
+    for (auto &heart : assets.hearts)
+    {
+        if(tempHealthVar > 0)
+        {
+            heart.isFull = true;
+            tempHealthVar--;
+        }
+        else
+        {
+            heart.isFull = false;
+
+        }
+        const SpriteFrame &drawHearts = heart.isFull ? heart.full : heart.empty;
+        list.texture(drawHearts.texture, drawHearts.rec, assets.heartUIPos, 5.f, RAYWHITE);
+        assets.heartUIPos.x += heartUIOffset.x;
+    }
+
+    assets.heartUIPos = {20, 5};
+
+    // [---------------- DRAW DEBUG TEXT -----------------]
+    if(debug.showDebugText)
+    {
+        constexpr int screenWidth{Sim::screenWidth};
+        Vector2 debugBoxPos{screenWidth - 335, 5};
+        int debugBoxPosX = static_cast<int>(debugBoxPos.x);
+        list.setPass(PASS_SCREEN, 1);
+        list.rectangle(debugBoxPos.x, debugBoxPos.y, 330, 260, fade(SKYBLUE, 0.5f));
+        list.setPass(PASS_SCREEN, 2);
+        list.text(format("FPS: %i", debug.fps), debugBoxPosX, 15, 30, BLACK);
+        list.text(format("- Position: (%06.3f, %06.3f, %06.3f)", cam.position.x, cam.position.y, cam.position.z), debugBoxPosX, 60, 10, BLACK);
+        list.text(format("- Target: (%06.3f, %06.3f, %06.3f)", cam.target.x, cam.target.y, cam.target.z), debugBoxPosX, 75, 10, BLACK);
+        list.text(format("- Up: (%06.3f, %06.3f, %06.3f)", cam.up.x, cam.up.y, cam.up.z), debugBoxPosX, 90, 10, BLACK);
+        list.text(format(" Forward Camera (%f, %f, %f)", sim.forward.x, sim.forward.y, sim.forward.z), debugBoxPosX, 105, 10, BLACK);
+        list.text(format("Current Run Speed: %f", sim.runSpeed), debugBoxPosX, 120, 10, BLACK);
+        if (sim.hasCappy)
+        {
+            Vector3 cappy = sim.cappyPosition;
+            list.text(format("Cappy Current Pos: %f, %f, %f", cappy.x, cappy.y, cappy.z), debugBoxPosX, 135, 10, BLACK);
+            list.text(format("Cappy Target Pos: %f, %f, %f", sim.cappyTarget.x, cappy.y, sim.cappyTarget.y), debugBoxPosX, 150, 10, BLACK);
+        }
+        list.text(format("Pies: %i / %i (peak %i)", static_cast<int>(sim.pies.size()), sim.pieCapacity, sim.pieHighWater), debugBoxPosX, 165, 10, BLACK);
+        list.text(format("Shots: %i / %i (peak %i)", static_cast<int>(sim.shots.size()), sim.shotCapacity, sim.shotHighWater), debugBoxPosX, 180, 10, BLACK);
+        list.text(format("Draw calls: %i  Vertices: %i  Instances: %i", debug.lastFrame.drawCalls, debug.lastFrame.vertices, debug.lastFrame.instances), debugBoxPosX, 195, 10, BLACK);
+        list.text(format("Visible: %i  Culled: %i", culler.stats().visible, culler.stats().culled), debugBoxPosX, 210, 10, BLACK);
+        list.text(format("Textures: %i  %.1f KiB", debug.textureCount, debug.textureBytes / 1024.0), debugBoxPosX, 225, 10, BLACK);
+        list.text(format("Entities: %i  Archetypes: %i", sim.entities, sim.archetypes), debugBoxPosX, 240, 10, BLACK);
+    }
+}
+
+SpriteFrame spriteFrame(const SceneAssets &assets, AtlasSprite sprite, int frame)
+{
+    return {assets.atlasPages[assets.spritePages[sprite]], assets.frames[spriteFrames[sprite].first + frame]};
+}
+
+void useStandInAtlas(SceneAssets &assets)
+{
+    assets.atlasPages.assign(1, {1, 256, 256, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8});
+    for (int &page : assets.spritePages)
+    {
+        page = 0;
+    }
+    for (Rectangle &frame : assets.frames)
+    {
+        frame = {0.f, 0.f, 32.f, 32.f};
+    }
+}
+
+// The animated banner, centred above the menu text
+static void recordBanner(const SceneAssets &assets, RenderList &list)
+{
+    constexpr int screenWidth{Sim::screenWidth};
+    constexpr int screenHeight{Sim::screenHeight};
+    const Texture2D &banner = assets.banner;
+    if (banner.id == 0)
+    {
+        return;
+    }
+    float scale = bannerHeight / static_cast<float>(banner.height);
+    list.texture(banner, {0.f, 0.f, static_cast<float>(banner.width), static_cast<float>(banner.height)},
+                 {screenWidth / 2.f - banner.width * scale / 2.f, screenHeight / 2.f - 30.f - bannerHeight}, scale, WHITE);
+}
+
+void recordScene(const SimSnapshot &sim, float alpha, SceneAssets &assets, const SceneDebug &debug, RenderList &list)
+{
+    constexpr int screenWidth{Sim::screenWidth};
+    constexpr int screenHeight{Sim::screenHeight};
+
+    if (sim.state == PLAYING)
+    {
+        recordPlaying(sim, alpha, assets, debug, list);
+        return;
+    }
+
+    // Menus are flat 2D screens
+    list.begin(sim.state == START_SCREEN ? LIGHTGRAY : BLACK, sim.view(alpha).cam);
+    list.setPass(PASS_SCREEN);
+    recordBanner(assets, list);
+
+    // [------------------ LOSE - GAME OVER ------------------]
+    if(sim.state == GAME_OVER)
+    {
+        list.centredText("Game Over", screenWidth / 2, screenHeight / 2 - 10, 20, RED);
+        list.centredText("Press R to Restart", screenWidth / 2, screenHeight / 2 + 20, 20, WHITE);
+    }
+    // [----------------- LOSE - KILLED CLOWNY ---------------]
+    else if (sim.state == GAME_OVER_CLOWNY_DEATH)
+    {
+        SpriteFrame cappyCry = spriteFrame(assets, SPRITE_CAPPY_CRY);
+        list.centredText("Game Over - YOU KILLED THE CLOWNYBARA", screenWidth / 2, screenHeight / 2 - 10, 20, RED);
+        list.centredText("Press R to Restart", screenWidth / 2, screenHeight / 2 + 20, 20, WHITE);
+        list.texture(cappyCry.texture, cappyCry.rec, {(float)(screenWidth / 2) - ((cappyCry.rec.width*3) /2), (float)screenHeight - (cappyCry.rec.height* 3)}, 3.f, RAYWHITE);
+    }
+    // [------------------ WIN - GAME OVER ------------------]
+    else if(sim.state == GAME_OVER_WIN)
+    {
+        list.centredText("YOU WIN! CLOWNYBARA IS SAVED :)", screenWidth / 2, screenHeight / 2 - 10, 30, GREEN);
+        list.centredText("Press R to Restart", screenWidth / 2, screenHeight / 2 + 20, 20, WHITE);
+    }
+    // [------------------ START MENU ------------------]
+    else if(sim.state == START_SCREEN)
+    {
+        list.centredText("SAVE THE CLOWNYBARA FROM THE EVIL GRUMULUM", screenWidth / 2, screenHeight / 2 - 10, 30, BLUE);
+        if (assets.loaded < 1.f)
+        {
+            list.centredText(format("Loading... %i%%", static_cast<int>(assets.loaded * 100.f)), screenWidth / 2, screenHeight / 2 + 20, 20, WHITE);
+        }
+        else
+        {
+            list.centredText("Press SPACE to start", screenWidth / 2, screenHeight / 2 + 20, 20, WHITE);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * Records what a frame of the game looks like into a RenderList - the
+ * playing view, the HUD and the menu / game over screens. Only reads a
+ * snapshot of the sim and the textures it is given, so the same frame can be
+ * recorded by the raylib front end or headless, and while the sim runs on.
+*/
+
+#ifndef GGJ24_SCENE_H
+#define GGJ24_SCENE_H
+
+#include "arena_mesh.h"
+#include "frustum_cull.h"
+#include "render_list.h"
+#include "sim_snapshot.h"
+#include "sprite_sheet.h"
+
+#include <cstddef>
+#include <vector>
+
+// One frame of the sprite atlas - the page texture it is on and where
+struct SpriteFrame
+{
+    Texture2D texture{};
+    Rectangle rec{};
+};
+
+struct HeartUI
+{
+    SpriteFrame full;
+    SpriteFrame empty;
+    bool isFull;
+    Rectangle rec;
+};
+
+// Textures and HUD layout the scene draws with, owned by the front end
+struct SceneAssets
+{
+    // The packed atlas, filled in by the front end: every frame of
+    // sprite_sheet.h is a rectangle on its sprite's page
+    std::vector<Texture2D> atlasPages;
+    int spritePages[SPRITE_COUNT]{};
+    Rectangle frames[spriteFrameCount]{};
+    // Fraction of the textures loaded, the start screen waits for 1
+    float loaded{1.f};
+    // Animated clownybara over the menus, a texture the front end updates
+    // in place. None (id 0) without the GIF
+    Texture2D banner{};
+
+    std::vector<HeartUI> hearts;
+    std::vector<HeartUI> grumHearts;
+    Vector2 heartUIPos{20, 5};
+    Vector3 grumHeartsPos{};
+
+    // Baked ground, walls and columns, rebaked by recordScene() when the arena changes
+    ArenaMesh arena;
+    // Frustum for the frame being recorded, its counters feed the debug overlay
+    FrustumCuller culler;
+};
+
+// Front end numbers shown on the debug overlay
+struct SceneDebug
+{
+    bool showDebugText{false};
+    int fps{0};
+    RenderStats lastFrame;
+    int textureCount{0};
+    size_t textureBytes{0};
+};
+
+SpriteFrame spriteFrame(const SceneAssets &assets, AtlasSprite sprite, int frame = 0);
+// One made-up page with every frame a 32 pixel square on it, for recording
+// frames with no art - headless, or in tests
+void useStandInAtlas(SceneAssets &assets);
+
+void recordScene(const SimSnapshot &sim, float alpha, SceneAssets &assets, const SceneDebug &debug, RenderList &list);
+
+#endif //GGJ24_SCENE_H
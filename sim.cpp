@@ -0,0 +1,765 @@
+#include "sim.h"
+
+#include "raymath.h"
+#include "swept_collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// raylib's CAMERA_FIRST_PERSON tuning (rcamera.h), movement scaled to per-second at 60 FPS
+constexpr float cameraMoveSpeed{0.09f * 60.f};
+constexpr float cameraMouseSensitivity{0.003f};
+// Rows per job when a stage splits its columns over the workers. Anything
+// smaller runs in one piece on whichever thread has the stage
+constexpr int entitiesPerJob{1024};
+constexpr int animationsPerJob{4096};
+// Wander spots and crowd homes are whole units in [-wanderRange, wanderRange] on x and z
+constexpr int wanderRange{10};
+
+// Keyed draws for an entity, generation included so a reused slot draws afresh
+static uint64_t randomSubject(Entity entity)
+{
+    return (static_cast<uint64_t>(entity.generation) << 32) | entity.index;
+}
+
+Sim::Sim(const SimConfig &config)
+    : tickRate(config.tickRate), animations(config.tickRate), jobs(config.workers),
+      arenaRandom(config.seed, "arena"), crowdRandom(config.seed, "crowd"),
+      wanderRandom(config.seed, "wander"), pieRandom(config.seed, "pies")
+{
+    // [----------------- Define Camera-----------------]
+    cam.position = (Vector3){0.0f, 2.0f, 4.0f};     // position
+    cam.target = (Vector3){0.0f, 2.0f, 0.0f};       // point camera is looking at/hitting
+    cam.up = (Vector3){0.0f, 1.0f, 0.0f};           // up Vector for Camera
+    cam.fovy = 60.0f;                               // camera's FOV
+    cam.projection = CAMERA_PERSPECTIVE;         // camera projection type
+
+    // Generate random columns in the room
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        int max_col_height = 12;
+        heights[i] = static_cast<float>(arenaRandom.nextInt(1, max_col_height));
+        positions[i] = (Vector3){ static_cast<float>(arenaRandom.nextInt(-15, 15)), heights[i]/2.0f,
+            static_cast<float>(arenaRandom.nextInt(-15, 15))};
+        colors[i] = (Color){
+            static_cast<unsigned char>(arenaRandom.nextInt(20, 255)),
+            static_cast<unsigned char>(arenaRandom.nextInt(10, 255)),
+            static_cast<unsigned char>(arenaRandom.nextInt(10, 255)), 255,};
+    }
+    buildArena();
+
+    // Frame timing comes from the source art, one clip per sprite
+    const SpriteFrames &cappyFrames = spriteFrames[SPRITE_CAPPY];
+    const SpriteFrames &grumFrames = spriteFrames[SPRITE_GRUM];
+    cappyClip = animations.addClip(&spriteFrameDurations[cappyFrames.first], cappyFrames.count);
+    grumClip = animations.addClip(&spriteFrameDurations[grumFrames.first], grumFrames.count);
+
+    // CLOWNY + GRUMULUM
+    cappy = spawnClownybara({0.0f, 1.0f, 0.0f});
+    grum = spawnGrumulum({3.0f, 1.0f, 0.0f}, cappy);
+    std::vector<int> homes(2 * static_cast<size_t>(std::max(config.crowd, 0)));
+    crowdRandom.fill(-wanderRange, wanderRange, static_cast<int>(homes.size()), homes.data());
+    for (int i = 0; i < config.crowd; i++)
+    {
+        Vector3 home{static_cast<float>(homes[2 * i]), 1.f, static_cast<float>(homes[2 * i + 1])};
+        spawnGrumulum(Vector3Add(home, {3.f, 0.f, 0.f}), spawnClownybara(home));
+    }
+
+    // Random targets for their movement
+    world.each<Wanderer>([&](Entity entity, Wanderer &wanderer)
+    {
+        pickWanderTarget(entity, wanderer);
+    });
+
+    buildStages();
+    previous = {cam, handPosition};
+}
+
+void Sim::step(const SimInputs &inputs, float dT)
+{
+    previous = {cam, handPosition};
+    time += dT;
+    tick++;
+
+    // The player moves first, everything else reacts to where they are now
+    updateCamera(inputs, dT);
+    updateMovement(inputs, dT);
+    stepSeconds = dT;
+    stages.run(jobs);
+    updateGameState(inputs);
+}
+
+void Sim::buildStages()
+{
+    // What reads what decides the order, everything else runs side by side.
+    // Sprites, shots and pies keep to their own state until the broadphase
+    // brings sprites and shots together; hits wait for the pies as well so
+    // the hit log comes out in the same order every run. Shots always fly
+    // and expire, pies and hit tests only run while playing
+    int targets = stages.add([this] { updateTargets(); });
+    int wander = stages.add([this] { updateWanderers(stepSeconds); }, {targets});
+    int follow = stages.add([this] { updateFollowers(stepSeconds); }, {targets});
+    stages.add([this] { updateAnimations(); });
+    int shots = stages.add([this] { integrateShots(stepSeconds); });
+    int piesDone = stages.add([this]
+    {
+        previousPieClock = pieClock;
+        if (currentGameState == PLAYING)
+        {
+            updatePies(stepSeconds);
+        }
+    });
+    int broadphaseBuilt = stages.add([this]
+    {
+        if (currentGameState == PLAYING)
+        {
+            buildBroadphase();
+        }
+    }, {wander, follow, shots});
+    int hits = stages.add([this]
+    {
+        if (currentGameState == PLAYING)
+        {
+            resolveCollisions();
+        }
+    }, {broadphaseBuilt, piesDone});
+    stages.add([this] { releaseSwept(playerProjectiles, shotSweep); }, {hits});
+}
+
+void Sim::updateCamera(const SimInputs &inputs, float dT)
+{
+    // [----------------- Update Camera Vectors -----------------]
+    // forward vector
+    forward = Vector3Subtract(cam.target, cam.position);
+    forward.y = 0;
+    Vector3Normalize(forward);
+
+    // right vector
+    right = Vector3CrossProduct(forward, cam.up);
+    Vector3Normalize(right);
+    // up vector
+    Vector3 up = {0.0f, 0.1f, 0.0f};
+    Vector3Normalize(up);
+
+    // update camera - same as UpdateCamera(&cam, CAMERA_FIRST_PERSON) but driven by inputs
+    Vector3 camUp = Vector3Normalize(cam.up);
+    Vector3 toTarget = Vector3Subtract(cam.target, cam.position);
+    toTarget = Vector3RotateByAxisAngle(toTarget, camUp, -inputs.mouseDelta.x * cameraMouseSensitivity);
+
+    float pitch = -inputs.mouseDelta.y * cameraMouseSensitivity;
+    float maxAngleUp = Vector3Angle(camUp, toTarget) - 0.001f;
+    float maxAngleDown = -Vector3Angle(Vector3Negate(camUp), toTarget) + 0.001f;
+    pitch = Clamp(pitch, maxAngleDown, maxAngleUp);
+    Vector3 camRight = Vector3Normalize(Vector3CrossProduct(toTarget, camUp));
+    toTarget = Vector3RotateByAxisAngle(toTarget, camRight, pitch);
+    cam.target = Vector3Add(cam.position, toTarget);
+
+    Vector3 planeForward = Vector3Normalize((Vector3){toTarget.x, 0.f, toTarget.z});
+    Vector3 planeRight = Vector3Normalize((Vector3){camRight.x, 0.f, camRight.z});
+    Vector3 camMove{};
+    if (inputs.moveForward) camMove = Vector3Add(camMove, planeForward);
+    if (inputs.moveBack) camMove = Vector3Subtract(camMove, planeForward);
+    if (inputs.moveRight) camMove = Vector3Add(camMove, planeRight);
+    if (inputs.moveLeft) camMove = Vector3Subtract(camMove, planeRight);
+    camMove = Vector3Scale(camMove, cameraMoveSpeed * dT);
+    cam.position = Vector3Add(cam.position, camMove);
+    cam.target = Vector3Add(cam.target, camMove);
+
+    // [-------------- HELD OBJECT POSITIONING -------------]
+    handPosition = cam.position;
+    handPosition = Vector3Add(handPosition, Vector3Scale(forward, handOffset.z));
+    handPosition = Vector3Add(handPosition, Vector3Scale(right, handOffset.x));
+    handPosition = Vector3Add(handPosition, Vector3Scale(up, handOffset.y));
+
+    // check if player is moving and adjust hand motion accordingly
+    if(isPlayerMoving)
+    {
+        handPosition.y += 0.1f * sinf(time * 4.0f);
+        handPosition.x += 0.1f * cosf(time * 4.0f);
+    }
+}
+
+void Sim::updateMovement(const SimInputs &inputs, float dT)
+{
+    // [----------------- +PROJECTILES+ ------------------]
+    world.each<PieThrower, Transform, Health>([&](Entity entity, PieThrower &thrower, Transform &transform, Health &health)
+    {
+        // Downed grumulums sit the rest of the fight out
+        thrower.timer += dT;
+        if (thrower.timer < thrower.interval || (health.current == 0 && currentGameState == PLAYING))
+        {
+            return;
+        }
+        thrower.timer = 0.0f;
+        uint32_t words[4];
+        pieRandom.block(randomSubject(entity), static_cast<uint64_t>(tick), words);
+        thrower.interval = static_cast<float>(RngStream::toInt(words[0], 1, 2));
+
+        // get camera pos
+        Vector3 directionToCamera = Vector3Subtract(cam.position, transform.position);
+        Vector3Normalize(directionToCamera);
+
+        // FIRE PIE
+        firePie(transform.position, directionToCamera, projectileSpeed);
+    });
+
+    // [----------- MOVEMENT + Action Check -----------------]
+    if (inputs.jump && !isAirborne)
+    {
+        isAirborne = true;
+        velocity = jumpHeight * referenceTickRate;
+    }
+
+    if (inputs.crouch && !isAirborne)
+    {
+        cam.position.y = 1.f;
+    }
+    if (inputs.crouchReleased)
+    {
+        cam.position.y = 2.f;
+    }
+
+    if (isAirborne)
+    {
+        cam.position.y += velocity * dT; // Update camera Y pos.
+        velocity -= gravity * referenceTickRate * dT;
+        isPlayerMoving = true;
+        if (cam.position.y <= groundLevel)
+        {
+            cam.position.y = groundLevel;
+            isAirborne = false;
+            velocity = 0.f;
+        }
+    }
+    if (inputs.moveForward)
+    {
+        Vector3 vStrafe = Vector3Scale(forward, runSpeed *dT);
+        cam.position = Vector3Add(cam.position, vStrafe);
+        cam.target = Vector3Add(cam.target, vStrafe);
+        isPlayerMoving = true;
+    }
+    if (inputs.moveBack)
+    {
+        Vector3 vStrafe = Vector3Scale(forward, runSpeed * dT);
+        cam.position = Vector3Subtract(cam.position, vStrafe);
+        cam.target = Vector3Subtract(cam.target, vStrafe);
+        isPlayerMoving = true;
+    }
+
+    if (inputs.moveLeft)
+    {
+        // camera adjustments
+        Vector3 strafe = Vector3Scale(right, runSpeed * dT);
+        cam.position = Vector3Subtract(cam.position, strafe);
+        cam.target = Vector3Subtract(cam.target, strafe);
+        isPlayerMoving = true;
+    }
+    if (inputs.moveRight)
+    {
+        Vector3 strafe = Vector3Scale(right, runSpeed * dT);
+        cam.position = Vector3Add(cam.position, strafe);
+        cam.target = Vector3Add(cam.target, strafe);
+        isPlayerMoving = true;
+    }
+    // [------------ SPRINTING ------------------]
+    runSpeed = inputs.sprint ? 3 : 1;
+
+    if (inputs.anyKeyPressed)
+    {
+        isPlayerMoving = false;
+    }
+
+    if (inputs.fire)
+    {
+        // Pool full means someone is out-clicking the lifetime, reuse the oldest shot
+        Vector3 shotSpeed = Vector3Scale(Vector3Normalize(Vector3Subtract(cam.target, cam.position)), playerProjectileSpeed);
+        playerProjectiles.spawnOrRecycleOldest(cam.position, shotSpeed);
+    }
+}
+
+void Sim::updateAnimations()
+{
+    // [----------------- ANIMATE CAPPY & GRUM ------------------]
+    // The animations hold still while the player is in the air
+    if (!isAirborne)
+    {
+        animations.tick();
+    }
+    jobs.parallelFor(animations.count(), animationsPerJob, [&](int begin, int end)
+    {
+        animations.evaluate(begin, end - begin);
+    });
+    world.eachChunk<Sprite>([&](int count, const Entity *, Sprite *sprites)
+    {
+        jobs.parallelFor(count, entitiesPerJob, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                sprites[i].frame = animations.frameOf(sprites[i].animation);
+            }
+        });
+    });
+}
+
+void Sim::updateTargets()
+{
+    world.eachChunk<Transform>([&](int count, const Entity *, Transform *transforms)
+    {
+        jobs.parallelFor(count, entitiesPerJob, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                transforms[i].previous = transforms[i].position;
+            }
+        });
+    });
+
+    // [----------------- MOVE SPRITES ------------------]
+    // Followers aim off where their leader is headed before it picks anywhere new
+    world.eachChunk<Follower>([&](int count, const Entity *, Follower *followers)
+    {
+        jobs.parallelFor(count, entitiesPerJob, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                const Transform *leader = world.get<Transform>(followers[i].leader);
+                const Wanderer *leaderTarget = world.get<Wanderer>(followers[i].leader);
+                if (leader != nullptr && leaderTarget != nullptr)
+                {
+                    followers[i].target = Vector3Add({leaderTarget->targetX, leader->position.y, leaderTarget->targetZ}, followers[i].offset);
+                }
+            }
+        });
+    });
+}
+
+void Sim::updateWanderers(float dT)
+{
+    // Wanderers head for their spot, and pick a new one once they are there
+    world.eachChunk<Wanderer, Transform, Mover>([&](int count, const Entity *entities, Wanderer *wanderers, Transform *transforms, Mover *movers)
+    {
+        jobs.parallelFor(count, entitiesPerJob, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                Vector3 target{wanderers[i].targetX, transforms[i].position.y, wanderers[i].targetZ};
+                if (checkVectorProximity(transforms[i].position, target))
+                {
+                    pickWanderTarget(entities[i], wanderers[i]);
+                    continue;
+                }
+                Vector3 direction = Vector3Subtract(target, transforms[i].position);
+                Vector3Normalize(direction);
+                direction = Vector3Scale(direction, (runSpeed + movers[i].speedOffset) * dT);
+                transforms[i].position = Vector3Add(transforms[i].position, direction);
+            }
+        });
+    });
+}
+
+void Sim::pickWanderTarget(Entity entity, Wanderer &wanderer) const
+{
+    uint32_t words[4];
+    wanderRandom.block(randomSubject(entity), static_cast<uint64_t>(tick), words);
+    wanderer.targetX = static_cast<float>(RngStream::toInt(words[0], -wanderRange, wanderRange));
+    wanderer.targetZ = static_cast<float>(RngStream::toInt(words[1], -wanderRange, wanderRange));
+}
+
+void Sim::updateFollowers(float dT)
+{
+    world.eachChunk<Follower, Transform, Mover>([&](int count, const Entity *, Follower *followers, Transform *transforms, Mover *movers)
+    {
+        jobs.parallelFor(count, entitiesPerJob, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                if (!checkVectorProximity(transforms[i].position, followers[i].target))
+                {
+                    Vector3 direction = Vector3Subtract(followers[i].target, transforms[i].position);
+                    Vector3Normalize(direction);
+                    direction = Vector3Scale(direction, (runSpeed + movers[i].speedOffset) * dT);
+                    transforms[i].position = Vector3Add(transforms[i].position, direction);
+                }
+            }
+        });
+    });
+}
+
+Entity Sim::spawnClownybara(Vector3 position)
+{
+    Sprite sprite{SPRITE_CAPPY, animations.add(cappyClip), 0};
+    return world.create(Transform{position, position}, Wanderer{position.x, position.z, position}, Mover{0.f}, sprite,
+                        Health{maxCappyHealth, maxCappyHealth}, Target{LAYER_CLOWNY});
+}
+
+Entity Sim::spawnGrumulum(Vector3 position, Entity leader)
+{
+    Sprite sprite{SPRITE_GRUM, animations.add(grumClip), 0};
+    // Grum keeps a step behind and above its clownybara, a little slower
+    Follower follower{leader, {-1.f, 1.f, -1.f}, position};
+    PieThrower thrower{0.f, static_cast<float>(pieRandom.nextInt(2, 5))};
+    return world.create(Transform{position, position}, follower, Mover{-0.5f}, sprite,
+                        Health{maxGrumHealth, maxGrumHealth}, Target{LAYER_ENEMY}, thrower);
+}
+
+void Sim::restoreHealth(CollisionLayer layer)
+{
+    world.each<Health, Target>([&](Entity, Health &health, Target &target)
+    {
+        if (target.layer == layer)
+        {
+            health.current = health.max;
+        }
+    });
+}
+
+void Sim::sendWanderersHome()
+{
+    world.each<Wanderer, Transform>([](Entity, Wanderer &wanderer, Transform &transform)
+    {
+        transform.position = wanderer.home;
+    });
+}
+
+unsigned int Sim::healthOf(Entity entity) const
+{
+    const Health *health = world.get<Health>(entity);
+    return health == nullptr ? 0 : health->current;
+}
+
+void Sim::integrateShots(float dT)
+{
+    playerProjectiles.integrate(dT, playerProjectileLifetime);
+    sweepAgainstArena(playerProjectiles, shotSweep, dT);
+}
+
+void Sim::updatePies(float dT)
+{
+    pieClock += dT;
+
+    // Only pies whose scheduled check is due get tested - unless the player
+    // outran the speed the schedule assumed, then nothing it promised holds
+    pieChecks.clear();
+    if (Vector3Distance(previous.cam.position, cam.position) > maxPlayerSpeed * dT)
+    {
+        for (int i = 0; i < pies.activeCount(); i++)
+        {
+            pieChecks.push_back(pies.id(i));
+        }
+    }
+    else
+    {
+        pies.popDueChecks(pieClock, pieChecks);
+    }
+
+    for (int pieId : pieChecks)
+    {
+        int index = pies.indexOf(pieId);
+        if (pieClock - dT >= pies.endTime(index))
+        {
+            continue;
+        }
+
+        // Pie and player both moved in a straight line this tick, test the
+        // pie's motion relative to the player against the player's radius
+        Vector3 from = Vector3Subtract(pies.position(index, pieClock - dT), previous.cam.position);
+        Vector3 to = Vector3Subtract(pies.position(index, pieClock), cam.position);
+        float t;
+        if (sweptSphere(from, to, {0.f, 0.f, 0.f}, playerHitRadius, &t))
+        {
+            printf("Hit registered\n");
+            // A crowd can land several pies on the tick the last heart goes
+            if (currentHealth > 0)
+            {
+                currentHealth--;
+            }
+            pies.releaseId(pieId);
+            continue;
+        }
+
+        // Nothing can touch before the gap closes at the pie's speed plus the
+        // player's top speed, no need to look at this pie again until then
+        float gap = Vector3Length(to) - playerHitRadius;
+        float closingSpeed = Vector3Length(pies.velocity(index)) + maxPlayerSpeed;
+        pies.scheduleCheck(pieId, pieClock + fmaxf(gap, 0.f) / closingSpeed);
+    }
+
+    // Wall hits were worked out at launch, so everything that ends now is done
+    pies.releaseExpired(pieClock);
+}
+
+void Sim::firePie(Vector3 startPosition, Vector3 direction, float speed)
+{
+    // The whole flight is known at launch - cut it short at the first wall or
+    // column along the way and check for the player straight away
+    Vector3 pieSpeed = Vector3Scale(direction, speed);
+    Vector3 flightEnd = Vector3Add(startPosition, Vector3Scale(pieSpeed, pieLifetime));
+    float t = 1.f;
+    int box;
+    arenaBvh.intersectSegment(startPosition, flightEnd, &t, &box);
+
+    int index = pies.spawn(startPosition, pieSpeed, pieClock, pieClock + t * pieLifetime);
+    if (index >= 0)
+    {
+        pies.scheduleCheck(pies.id(index), pieClock);
+    }
+}
+
+void Sim::buildArena()
+{
+    // Same boxes the renderer draws - ground plane, the four walls and the columns
+    float half = arenaSize / 2.f;
+    arenaBoxes.clear();
+    arenaBoxes.push_back({{-half, -1.f, -half}, {half, 0.f, half}});             // ground plane
+    arenaBoxes.push_back({{-half - .5f, 0.f, -half}, {-half + .5f, 5.f, half}}); // BLUE WALL
+    arenaBoxes.push_back({{half - .5f, 0.f, -half}, {half + .5f, 5.f, half}});   // LIME WALL
+    arenaBoxes.push_back({{-half, 0.f, half - .5f}, {half, 5.f, half + .5f}});   // GOLD WALL
+    arenaBoxes.push_back({{-half, 0.f, -half - .5f}, {half, 5.f, -half + .5f}}); // DarkGray WALL
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        Vector3 halfExtent = {1.f, heights[i] / 2.f, 1.f};
+        arenaBoxes.push_back({Vector3Subtract(positions[i], halfExtent), Vector3Add(positions[i], halfExtent)});
+    }
+    arenaBvh.build(arenaBoxes);
+    arenaRevision++;
+}
+
+void Sim::sweepAgainstArena(const ProjectileStore &store, ProjectileSweep &sweep, float dT)
+{
+    // The segment each projectile covered this tick, never reaching back past its spawn point
+    int count = store.activeCount();
+    sweep.from.resize(count);
+    sweep.to.resize(count);
+    sweep.geometryHits.resize(count);
+    sweep.geometryT.resize(count);
+    sweep.releaseIds.clear();
+    for (int i = 0; i < count; i++)
+    {
+        sweep.to[i] = store.position(i);
+        sweep.from[i] = Vector3Subtract(sweep.to[i], Vector3Scale(store.speed(i), fminf(dT, store.timeAlive[i])));
+    }
+
+    // Anything that hit a wall or column stops there - cut its move short so
+    // it can't also hit something behind the wall
+    int hits = arenaBvh.intersectSegments(count, sweep.from.data(), sweep.to.data(), sweep.geometryHits.data(), sweep.geometryT.data());
+    for (int h = 0; h < hits; h++)
+    {
+        int i = sweep.geometryHits[h];
+        sweep.to[i] = Vector3Lerp(sweep.from[i], sweep.to[i], sweep.geometryT[h]);
+        sweep.releaseIds.push_back(store.id(i));
+    }
+}
+
+void Sim::buildBroadphase()
+{
+    // [----------------- BROADPHASE ------------------]
+    // Everything is swept over the tick so fast shots can't tunnel through targets
+    broadphase.clear();
+    hitTargets.clear();
+    world.each<Target, Transform, Health>([&](Entity entity, Target &target, Transform &transform, Health &health)
+    {
+        // Downed ones are out of the fight
+        if (health.current > 0)
+        {
+            broadphase.insertSwept(target.layer, static_cast<int>(hitTargets.size()), transform.previous, transform.position, spriteHitRadius);
+            hitTargets.push_back(entity);
+        }
+    });
+    for (int i = 0; i < playerProjectiles.activeCount(); i++)
+    {
+        broadphase.insertSwept(LAYER_PLAYER_SHOT, playerProjectiles.id(i), shotSweep.from[i], shotSweep.to[i], 0.f);
+    }
+    broadphase.build();
+}
+
+void Sim::resolveCollisions()
+{
+    // [----------------- HITS ------------------]
+    shotHits.clear();
+    broadphase.forEachPair(LAYER_PLAYER_SHOT, LAYER_ENEMY, [&](int shotId, int target, float t)
+    {
+        shotHits.push_back({shotId, t, LAYER_ENEMY, target});
+    });
+    broadphase.forEachPair(LAYER_PLAYER_SHOT, LAYER_CLOWNY, [&](int shotId, int target, float t)
+    {
+        shotHits.push_back({shotId, t, LAYER_CLOWNY, target});
+    });
+
+    // A shot stops at whatever it touches first
+    std::sort(shotHits.begin(), shotHits.end(), [](const ShotHit &a, const ShotHit &b)
+    {
+        return a.shotId != b.shotId ? a.shotId < b.shotId : a.t < b.t;
+    });
+    for (size_t h = 0; h < shotHits.size(); h++)
+    {
+        if (h > 0 && shotHits[h].shotId == shotHits[h - 1].shotId)
+        {
+            continue;
+        }
+        if (shotHits[h].target == LAYER_ENEMY)
+        {
+            printf("Hit grum\n");
+        }
+        else
+        {
+            printf("HIT CAPPY!");
+        }
+        // Two shots on the same tick can both get through before it is downed
+        Health *health = world.get<Health>(hitTargets[shotHits[h].targetIndex]);
+        if (health != nullptr && health->current > 0)
+        {
+            health->current--;
+        }
+        shotSweep.releaseIds.push_back(shotHits[h].shotId);
+    }
+}
+
+void Sim::releaseSwept(ProjectileStore &store, ProjectileSweep &sweep)
+{
+    // A projectile can be on the list twice (hit a wall and a target on the same tick)
+    std::sort(sweep.releaseIds.begin(), sweep.releaseIds.end());
+    sweep.releaseIds.erase(std::unique(sweep.releaseIds.begin(), sweep.releaseIds.end()), sweep.releaseIds.end());
+    for (int projectileId : sweep.releaseIds)
+    {
+        store.releaseId(projectileId);
+    }
+    sweep.releaseIds.clear();
+}
+
+void Sim::updateGameState(const SimInputs &inputs)
+{
+    if (currentGameState == PLAYING)
+    {
+        if (currentHealth == 0)
+        {
+            currentGameState = GAME_OVER;
+        }
+        // Won once every grumulum is down, lost if any clownybara is
+        bool enemiesStanding = false;
+        bool clownyDown = false;
+        world.each<Health, Target>([&](Entity, Health &health, Target &target)
+        {
+            enemiesStanding = enemiesStanding || (target.layer == LAYER_ENEMY && health.current > 0);
+            clownyDown = clownyDown || (target.layer == LAYER_CLOWNY && health.current == 0);
+        });
+        if (!enemiesStanding)
+        {
+            currentGameState = GAME_OVER_WIN;
+        }
+        if (clownyDown)
+        {
+            currentGameState = GAME_OVER_CLOWNY_DEATH;
+        }
+    }
+    // [------------------ LOSE - GAME OVER ------------------]
+    else if (currentGameState == GAME_OVER)
+    {
+        if (inputs.restart)
+        {
+            // Reset Game State
+            currentGameState = START_SCREEN;
+            currentHealth = maxHealth;
+            sendWanderersHome();
+        }
+    }
+    // [----------------- LOSE - KILLED CLOWNY ---------------]
+    else if (currentGameState == GAME_OVER_CLOWNY_DEATH)
+    {
+        if (inputs.restart)
+        {
+            // Reset Game State
+            currentGameState = START_SCREEN;
+            currentHealth = maxHealth;
+            restoreHealth(LAYER_ENEMY);
+            restoreHealth(LAYER_CLOWNY);
+            sendWanderersHome();
+        }
+    }
+    // [------------------ WIN - GAME OVER ------------------]
+    else if (currentGameState == GAME_OVER_WIN)
+    {
+        if (inputs.restart)
+        {
+            // Reset Game State
+            currentGameState = START_SCREEN;
+            currentHealth = maxHealth;
+            restoreHealth(LAYER_ENEMY);
+            sendWanderersHome();
+        }
+    }
+    // [------------------ START MENU ------------------]
+    else if (currentGameState == START_SCREEN)
+    {
+        if (inputs.start)
+        {
+            currentGameState = PLAYING;
+        }
+    }
+}
+
+uint64_t Sim::checksum() const
+{
+    // FNV-1a over the state's bytes - everything hashed is built of 4 and 8
+    // byte fields, so there is no padding to trip over
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&](const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+    };
+    int flags[] = {currentGameState, isAirborne ? 1 : 0, isPlayerMoving ? 1 : 0};
+    mix(&tick, sizeof(tick));
+    mix(flags, sizeof(flags));
+    mix(&cam, sizeof(cam));
+    mix(&handPosition, sizeof(handPosition));
+    mix(&currentHealth, sizeof(currentHealth));
+    mix(&velocity, sizeof(velocity));
+    mix(&runSpeed, sizeof(runSpeed));
+    mix(&pieClock, sizeof(pieClock));
+
+    world.eachChunk<Transform, Health>([&](int count, const Entity *entities, const Transform *transforms, const Health *health)
+    {
+        mix(entities, sizeof(Entity) * count);
+        mix(transforms, sizeof(Transform) * count);
+        mix(health, sizeof(Health) * count);
+    });
+    world.eachChunk<Wanderer>([&](int count, const Entity *, const Wanderer *wanderers)
+    {
+        mix(wanderers, sizeof(Wanderer) * count);
+    });
+    world.eachChunk<PieThrower>([&](int count, const Entity *, const PieThrower *throwers)
+    {
+        mix(throwers, sizeof(PieThrower) * count);
+    });
+
+    int pieCount = pies.activeCount();
+    for (const std::vector<float> *column : {&pies.ox, &pies.oy, &pies.oz, &pies.vx, &pies.vy, &pies.vz})
+    {
+        mix(column->data(), sizeof(float) * pieCount);
+    }
+    mix(pies.launch.data(), sizeof(double) * pieCount);
+    mix(pies.end.data(), sizeof(double) * pieCount);
+    int shotCount = playerProjectiles.activeCount();
+    for (const std::vector<float> *column : {&playerProjectiles.x, &playerProjectiles.y, &playerProjectiles.z,
+                                             &playerProjectiles.vx, &playerProjectiles.vy, &playerProjectiles.vz,
+                                             &playerProjectiles.timeAlive})
+    {
+        mix(column->data(), sizeof(float) * shotCount);
+    }
+    return hash;
+}
+
+bool checkVectorEquality(Vector3 v1, Vector3 v2)
+{
+    return (v1.x == v2.x) && (v1.y == v2.y) && (v1.z == v2.z);
+}
+
+bool checkVectorProximity(Vector3 v1, Vector3 v2)
+{
+    float threshold = 0.1f;
+    return Vector3Distance(v1, v2) < threshold;
+}
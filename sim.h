@@ -0,0 +1,294 @@
+/**
+ * GGJ24 simulation core.
+ * Owns all game state and advances it with step(inputs, dt). Nothing in here
+ * touches the window, the GL context or raylib's input polling, so the sim
+ * can be run headless (see null_backend.h).
+*/
+
+#ifndef GGJ24_SIM_H
+#define GGJ24_SIM_H
+
+#include "arena_bvh.h"
+#include "ecs.h"
+#include "job_system.h"
+#include "projectile_store.h"
+#include "raylib.h"
+#include "rng.h"
+#include "spatial_hash.h"
+#include "sprite_animator.h"
+#include "sprite_sheet.h"
+#include "trajectory_store.h"
+
+#include <vector>
+
+#define MAX_COLUMNS 20
+#define MAX_PROJECTILES 20
+
+// [-------------- COMPONENTS -----------------------]
+// Clownybaras and grumulums are entities in Sim::world made of these
+
+// Where an entity is this tick and was last tick, for interpolation and swept hits
+struct Transform
+{
+    Vector3 position;
+    Vector3 previous;
+};
+
+// Roams between random spots on the floor, sent back home on a restart
+struct Wanderer
+{
+    float targetX;
+    float targetZ;
+    Vector3 home;
+};
+
+// Trails its leader's wander target by offset
+struct Follower
+{
+    Entity leader;
+    Vector3 offset;
+    Vector3 target;
+};
+
+// Closes on its target at the player's run speed plus speedOffset
+struct Mover
+{
+    float speedOffset;
+};
+
+// A billboard of an atlas sprite, frame is this tick's within the sprite
+struct Sprite
+{
+    AtlasSprite sprite;
+    int animation;              // row in Sim::animations
+    int frame;
+};
+
+struct Health
+{
+    unsigned int current;
+    unsigned int max;
+};
+
+// Something the player's shots can hit, in this collision layer
+struct Target
+{
+    CollisionLayer layer;
+};
+
+// Lobs a pie at the player every interval seconds
+struct PieThrower
+{
+    float timer;
+    float interval;
+};
+
+enum GameState
+{
+    START_SCREEN,
+    PLAYING,
+    GAME_OVER,
+    GAME_OVER_WIN,
+    GAME_OVER_CLOWNY_DEATH
+};
+
+// Everything the sim needs from the player for one step. Front ends fill this
+// from raylib (or a script) - the sim never polls input itself.
+struct SimInputs
+{
+    bool moveForward{false};    // KEY_W held
+    bool moveBack{false};       // KEY_S held
+    bool moveLeft{false};       // KEY_A held
+    bool moveRight{false};      // KEY_D held
+    bool sprint{false};         // KEY_LEFT_SHIFT held
+    bool crouch{false};         // KEY_SPACE held
+    bool crouchReleased{false}; // KEY_SPACE released
+    bool jump{false};           // MOUSE_BUTTON_RIGHT pressed
+    bool fire{false};           // MOUSE_BUTTON_LEFT pressed
+    bool start{false};          // KEY_SPACE pressed
+    bool restart{false};        // KEY_R pressed
+    bool anyKeyPressed{false};  // GetKeyPressed() != 0
+    Vector2 mouseDelta{};
+};
+
+struct SimConfig
+{
+    // Every random draw in the match comes from this, the same seed plays out the same
+    unsigned int seed{0};
+    // Fixed simulation rate in Hz (60, 120 or 240), independent of the render rate
+    int tickRate{60};
+    // Extra clownybara + grumulum pairs on top of Cappy and Grum
+    int crowd{0};
+    // Threads the tick is spread over besides the caller's, -1 for one per core
+    int workers{-1};
+};
+
+// Camera and hand, blended between the previous and current tick by SimSnapshot::view()
+struct RenderState
+{
+    Camera cam;
+    Vector3 handPosition;
+};
+
+class Sim
+{
+public:
+    explicit Sim(const SimConfig &config);
+
+    // Advance one fixed tick, dT should be tickSeconds()
+    void step(const SimInputs &inputs, float dT);
+
+    float tickSeconds() const { return 1.f / static_cast<float>(tickRate); }
+
+    // An entity's health, 0 once it is gone
+    unsigned int healthOf(Entity entity) const;
+    // Hash of the game state. Two sims that played the same ticks agree on it
+    // bit for bit, replays check themselves against it
+    uint64_t checksum() const;
+
+    // [-------------- CONSTANTS -----------------------]
+    static constexpr int screenWidth{1200};
+    static constexpr int screenHeight{800};
+    static constexpr unsigned int maxHealth{3};
+    static constexpr unsigned int maxGrumHealth{3};
+    static constexpr unsigned int maxCappyHealth{1};
+    static constexpr int pieNum{1000};
+    static constexpr float projectileSpeed{2.5f};
+    static constexpr float pieLifetime{100.f};
+    static constexpr float playerProjectileSpeed{50.f};
+    // 2s at 50 u/s is well past the far corner of the arena
+    static constexpr float playerProjectileLifetime{2.f};
+    static constexpr int maxPlayerProjectiles{64};
+    // Jump was tuned per frame at 60 FPS, these scale it to per second
+    static constexpr float referenceTickRate{60.f};
+    static constexpr float jumpHeight{1.5f};
+    static constexpr float gravity{9.8f};
+    static constexpr float groundLevel{2.f};
+    static constexpr float arenaSize{32.f};
+    // Hit radii for the broadphase, projectiles are points
+    static constexpr float playerHitRadius{.5f};
+    static constexpr float spriteHitRadius{.3f};
+    // Fastest the player can walk + strafe (sprinting, diagonally). Pie hit checks
+    // are scheduled against it, anything faster (jumps, crouching) rechecks every pie
+    static constexpr float maxPlayerSpeed{30.f};
+
+    // [-------------- STATE -----------------------]
+    GameState currentGameState{START_SCREEN};
+    Camera cam{};
+    Vector3 forward{};
+    Vector3 right{};
+    Vector3 handPosition{};
+    Vector3 handOffset{0.5f, -0.6f, .8f};
+
+    // Arena columns
+    float heights[MAX_COLUMNS]{0};
+    Vector3 positions[MAX_COLUMNS]{};
+    Color colors[MAX_COLUMNS]{};
+    // Floor, walls and columns as boxes, projectiles stop when they hit one
+    std::vector<BoundingBox> arenaBoxes;
+    ArenaBvh arenaBvh;
+    // Bumped by every rebuild of the arena, so baked copies know to rebuild too
+    int arenaRevision{0};
+
+    // Every clownybara and grumulum. Cappy and Grum are the first two, the
+    // ones the HUD follows
+    World world;
+    Entity cappy;
+    Entity grum;
+
+    TrajectoryStore pies{pieNum};
+    ProjectileStore playerProjectiles{maxPlayerProjectiles};
+
+    unsigned int currentHealth{maxHealth};
+
+    bool isAirborne{false};
+    bool isPlayerMoving{false};
+    float velocity{0};
+    float runSpeed{1.f};
+    float time{0.f};
+    long long tick{0};
+    int tickRate{60};
+    // Every sprite's animation, evaluated in one pass per tick
+    SpriteAnimator animations;
+    // Runs the stages of each tick after the player's move
+    JobSystem jobs;
+
+private:
+    // Copies out what the renderer needs, private clocks included
+    friend struct SimSnapshot;
+
+    void updateCamera(const SimInputs &inputs, float dT);
+    void updateMovement(const SimInputs &inputs, float dT);
+    // The stages run as jobs, see buildStages()
+    void buildStages();
+    void updateAnimations();
+    // Saves last tick's positions and points followers after their leaders
+    void updateTargets();
+    void updateWanderers(float dT);
+    // A new spot for entity, by entity and tick so any thread can draw it
+    void pickWanderTarget(Entity entity, Wanderer &wanderer) const;
+    void updateFollowers(float dT);
+    Entity spawnClownybara(Vector3 position);
+    Entity spawnGrumulum(Vector3 position, Entity leader);
+    // Back to full health for everything in layer
+    void restoreHealth(CollisionLayer layer);
+    // Clownybaras back to where they started
+    void sendWanderersHome();
+    void integrateShots(float dT);
+    void updatePies(float dT);
+    void firePie(Vector3 startPosition, Vector3 direction, float speed);
+    // This tick's move for every live projectile in a store (by dense index),
+    // cut short where it hit level geometry, plus the ids to release after hits
+    struct ProjectileSweep
+    {
+        std::vector<Vector3> from;
+        std::vector<Vector3> to;
+        std::vector<int> geometryHits;
+        std::vector<float> geometryT;
+        std::vector<int> releaseIds;
+    };
+
+    // A player shot touching a sprite, only the earliest one per shot counts
+    struct ShotHit
+    {
+        int shotId;
+        float t;
+        CollisionLayer target;
+        int targetIndex;        // into hitTargets
+    };
+
+    void buildBroadphase();
+    void resolveCollisions();
+    void buildArena();
+    void sweepAgainstArena(const ProjectileStore &store, ProjectileSweep &sweep, float dT);
+    void releaseSwept(ProjectileStore &store, ProjectileSweep &sweep);
+    void updateGameState(const SimInputs &inputs);
+
+    RenderState previous{};
+    TaskGraph stages;
+    float stepSeconds{0.f};
+
+    SpatialHash broadphase{arenaSize, 2.f};
+    ProjectileSweep shotSweep;
+    std::vector<ShotHit> shotHits;
+    // Pies only move while playing, so they run on their own clock
+    double pieClock{0.0};
+    double previousPieClock{0.0};
+    std::vector<int> pieChecks;
+    // What the broadphase ids of sprite bodies refer to this tick
+    std::vector<Entity> hitTargets;
+    int cappyClip{0};
+    int grumClip{0};
+
+    // A stream per system, all keyed from SimConfig::seed
+    RngStream arenaRandom;      // column layout
+    RngStream crowdRandom;      // where the extra pairs start
+    RngStream wanderRandom;     // wander spots, by entity and tick
+    RngStream pieRandom;        // throw intervals, by entity and tick
+};
+
+// Function Declarations
+bool checkVectorEquality(Vector3 v1, Vector3 v2);
+bool checkVectorProximity(Vector3 v1, Vector3 v2);
+
+#endif //GGJ24_SIM_H
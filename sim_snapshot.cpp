@@ -0,0 +1,109 @@
+#include "sim_snapshot.h"
+
+#include "raymath.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SimSnapshot::capture(const Sim &sim)
+{
+    tick = sim.tick;
+    state = sim.currentGameState;
+    tickSeconds = sim.tickSeconds();
+    alpha = 1.f;
+    previous = sim.previous;
+    current = {sim.cam, sim.handPosition};
+
+    // The columns only change with the arena, no need to copy them every frame
+    if (arenaRevision != sim.arenaRevision)
+    {
+        std::copy(std::begin(sim.heights), std::end(sim.heights), heights);
+        std::copy(std::begin(sim.positions), std::end(sim.positions), positions);
+        std::copy(std::begin(sim.colors), std::end(sim.colors), colors);
+        arenaRevision = sim.arenaRevision;
+    }
+
+    sprites.clear();
+    sim.world.eachChunk<Transform, Sprite>([&](int count, const Entity *, const Transform *transforms, const Sprite *spriteColumn)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            sprites.push_back({spriteColumn[i].sprite, spriteColumn[i].frame, transforms[i].previous, transforms[i].position});
+        }
+    });
+
+    const TrajectoryStore &pieStore = sim.pies;
+    pies.resize(pieStore.activeCount());
+    for (int i = 0; i < pieStore.activeCount(); i++)
+    {
+        pies[i] = {{pieStore.ox[i], pieStore.oy[i], pieStore.oz[i]}, pieStore.velocity(i), pieStore.launch[i], pieStore.end[i]};
+    }
+    previousPieClock = sim.previousPieClock;
+    pieClock = sim.pieClock;
+
+    const ProjectileStore &shotStore = sim.playerProjectiles;
+    shots.resize(shotStore.activeCount());
+    for (int i = 0; i < shotStore.activeCount(); i++)
+    {
+        shots[i] = {shotStore.position(i), shotStore.speed(i), shotStore.timeAlive[i]};
+    }
+
+    health = sim.currentHealth;
+    grumHealth = sim.healthOf(sim.grum);
+    cappyHealth = sim.healthOf(sim.cappy);
+
+    forward = sim.forward;
+    runSpeed = sim.runSpeed;
+    const Transform *cappy = sim.world.get<Transform>(sim.cappy);
+    const Wanderer *cappyWander = sim.world.get<Wanderer>(sim.cappy);
+    hasCappy = cappy != nullptr && cappyWander != nullptr;
+    if (hasCappy)
+    {
+        cappyPosition = cappy->position;
+        cappyTarget = {cappyWander->targetX, cappyWander->targetZ};
+    }
+    pieCapacity = pieStore.capacity();
+    pieHighWater = pieStore.highWaterMark();
+    shotCapacity = shotStore.capacity();
+    shotHighWater = shotStore.highWaterMark();
+    entities = sim.world.entityCount();
+    archetypes = sim.world.archetypeCount();
+}
+
+RenderState SimSnapshot::view(float blend) const
+{
+    if (blend >= 1.f)
+    {
+        return current;
+    }
+
+    RenderState state{current.cam, {}};
+    state.cam.position = Vector3Lerp(previous.cam.position, current.cam.position, blend);
+    state.cam.target = Vector3Lerp(previous.cam.target, current.cam.target, blend);
+    state.handPosition = Vector3Lerp(previous.handPosition, current.handPosition, blend);
+    return state;
+}
+
+Vector3 SimSnapshot::spritePosition(int index, float blend) const
+{
+    const SpriteSnapshot &sprite = sprites[index];
+    return blend >= 1.f ? sprite.position : Vector3Lerp(sprite.previous, sprite.position, blend);
+}
+
+Vector3 SimSnapshot::piePosition(int index, float blend) const
+{
+    // Same sums as TrajectoryStore::position()
+    const PieSnapshot &pie = pies[index];
+    double time = previousPieClock + (pieClock - previousPieClock) * blend;
+    float flight = static_cast<float>(std::clamp(time, pie.launch, pie.end) - pie.launch);
+    return Vector3Add(pie.origin, Vector3Scale(pie.velocity, flight));
+}
+
+Vector3 SimSnapshot::shotPosition(int index, float blend) const
+{
+    // Shots fly in straight lines, so stepping back along the velocity is
+    // the same as lerping from last tick - but never back past the spawn point
+    const ShotSnapshot &shot = shots[index];
+    float back = fminf((1.f - blend) * tickSeconds, shot.timeAlive);
+    return Vector3Subtract(shot.position, Vector3Scale(shot.speed, back));
+}
@@ -0,0 +1,96 @@
+/**
+ * Everything a frame is drawn from, copied out of the sim after its ticks:
+ * the camera, every sprite, pie and shot with what it takes to interpolate
+ * them, the arena columns and the HUD numbers. The renderer only ever reads
+ * a snapshot, never the Sim, so the next ticks can run on another thread
+ * while this one is drawn (see runPipelinedSimLoop()). capture() reuses the
+ * snapshot's storage, keep one around rather than making a new one a frame.
+*/
+
+#ifndef GGJ24_SIM_SNAPSHOT_H
+#define GGJ24_SIM_SNAPSHOT_H
+
+#include "sim.h"
+
+#include <vector>
+
+struct SpriteSnapshot
+{
+    AtlasSprite sprite;
+    int frame;
+    Vector3 previous;
+    Vector3 position;
+};
+
+// A pie's whole flight, placed by whatever time the renderer asks for
+struct PieSnapshot
+{
+    Vector3 origin;
+    Vector3 velocity;
+    double launch;
+    double end;
+};
+
+struct ShotSnapshot
+{
+    Vector3 position;
+    Vector3 speed;
+    float timeAlive;
+};
+
+struct SimSnapshot
+{
+    long long tick{0};
+    GameState state{START_SCREEN};
+    float tickSeconds{1.f / 60.f};
+    // How far the sim's clock had run past tick when this was taken (0..1),
+    // the blend for a renderer that can't ask for its own
+    float alpha{1.f};
+
+    // [-------------- VIEW -----------------------]
+    RenderState previous{};
+    RenderState current{};
+
+    // [-------------- ARENA -----------------------]
+    int arenaRevision{-1};
+    float heights[MAX_COLUMNS]{};
+    Vector3 positions[MAX_COLUMNS]{};
+    Color colors[MAX_COLUMNS]{};
+
+    // [-------------- MOVING -----------------------]
+    // Sprites in archetype order, as the world holds them
+    std::vector<SpriteSnapshot> sprites;
+    std::vector<PieSnapshot> pies;
+    double previousPieClock{0.0};
+    double pieClock{0.0};
+    std::vector<ShotSnapshot> shots;
+
+    // [-------------- HUD -----------------------]
+    unsigned int health{0};
+    unsigned int grumHealth{0};
+    unsigned int cappyHealth{0};
+
+    // [-------------- DEBUG OVERLAY -----------------------]
+    Vector3 forward{};
+    float runSpeed{0.f};
+    bool hasCappy{false};
+    Vector3 cappyPosition{};
+    Vector2 cappyTarget{};
+    int pieCapacity{0};
+    int pieHighWater{0};
+    int shotCapacity{0};
+    int shotHighWater{0};
+    int entities{0};
+    int archetypes{0};
+
+    // Copies sim's state as of its last tick, alpha is left at 1
+    void capture(const Sim &sim);
+
+    // Positions blended between the last two ticks, 0 being the previous one
+    RenderState view(float blend) const;
+    Vector3 spritePosition(int index, float blend) const;
+    Vector3 piePosition(int index, float blend) const;
+    Vector3 shotPosition(int index, float blend) const;
+};
+
+#endif //GGJ24_SIM_SNAPSHOT_H
@@ -0,0 +1,66 @@
+#include "spatial_hash.h"
+
+SpatialHash::SpatialHash(float arenaSize, float cellSize)
+    : halfSize(arenaSize / 2.f), inverseCellSize(1.f / cellSize)
+{
+    cellsPerSide = std::max(1, static_cast<int>(std::ceil(arenaSize / cellSize)));
+    cellCount = cellsPerSide * cellsPerSide;
+    cellStart.assign(LAYER_COUNT * cellCount + 1, 0);
+}
+
+void SpatialHash::clear()
+{
+    pending.clear();
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        layerCounts[layer] = 0;
+        layerMaxReach[layer] = 0.f;
+    }
+}
+
+int SpatialHash::cellOf(float x, float z, int *cellX, int *cellZ) const
+{
+    *cellX = std::clamp(static_cast<int>((x + halfSize) * inverseCellSize), 0, cellsPerSide - 1);
+    *cellZ = std::clamp(static_cast<int>((z + halfSize) * inverseCellSize), 0, cellsPerSide - 1);
+    return cellIndex(*cellX, *cellZ);
+}
+
+void SpatialHash::insert(CollisionLayer layer, int id, Vector3 position, float radius)
+{
+    insertSwept(layer, id, position, position, radius);
+}
+
+void SpatialHash::insertSwept(CollisionLayer layer, int id, Vector3 from, Vector3 to, float radius)
+{
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+    float dz = to.z - from.z;
+    float reach = radius + 0.5f * sqrtf(dx * dx + dy * dy + dz * dz);
+
+    int cellX, cellZ;
+    int cell = cellOf(from.x + dx * 0.5f, from.z + dz * 0.5f, &cellX, &cellZ);
+    pending.push_back({from.x, from.y, from.z, dx, dy, dz, radius, reach, id, layer * cellCount + cell});
+    layerCounts[layer]++;
+    layerMaxReach[layer] = std::max(layerMaxReach[layer], reach);
+}
+
+void SpatialHash::build()
+{
+    // Counting sort by (layer, cell) - two linear passes, no per-cell allocations
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (const Body &body : pending)
+    {
+        cellStart[body.key + 1]++;
+    }
+    for (size_t key = 1; key < cellStart.size(); key++)
+    {
+        cellStart[key] += cellStart[key - 1];
+    }
+
+    sorted.resize(pending.size());
+    scatterCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (const Body &body : pending)
+    {
+        sorted[scatterCursor[body.key]++] = body;
+    }
+}
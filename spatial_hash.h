@@ -0,0 +1,131 @@
+/**
+ * Uniform grid broadphase over the arena floor (XZ plane).
+ * Bodies are registered each tick with a collision layer, then build() counting
+ * sorts them by (layer, cell) so every layer has its own packed grid. Pair
+ * queries only ever walk the two layers asked for, so shot vs shot never
+ * gets looked at. Bodies can be swept over the tick, the narrowphase
+ * then tests their relative motion segment against the summed radii.
+*/
+
+#ifndef GGJ24_SPATIAL_HASH_H
+#define GGJ24_SPATIAL_HASH_H
+
+#include "raylib.h"
+#include "swept_collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+enum CollisionLayer
+{
+    LAYER_ENEMY,
+    LAYER_CLOWNY,
+    LAYER_PLAYER_SHOT,
+    LAYER_COUNT
+};
+
+class SpatialHash
+{
+public:
+    // arenaSize is the side of the square floor centred on the origin, anything
+    // outside it is clamped into the edge cells
+    SpatialHash(float arenaSize, float cellSize);
+
+    void clear();
+    void insert(CollisionLayer layer, int id, Vector3 position, float radius);
+    // Body that moved from -> to during the tick
+    void insertSwept(CollisionLayer layer, int id, Vector3 from, Vector3 to, float radius);
+    void build();
+
+    int bodyCount(CollisionLayer layer) const { return layerCounts[layer]; }
+
+    // Calls onHit(idA, idB, t) for every body in layer a that touches a body in
+    // layer b during the tick, t being the fraction of the tick they first touch
+    template<typename F>
+    void forEachPair(CollisionLayer a, CollisionLayer b, F &&onHit) const;
+
+private:
+    struct Body
+    {
+        float x, y, z;      // start of the move
+        float dx, dy, dz;   // motion over the tick
+        float radius;
+        float reach;        // radius plus half the move, around the midpoint
+        int id;
+        int key;            // layer * cellCount + cell of the midpoint
+    };
+
+    int cellOf(float x, float z, int *cellX, int *cellZ) const;
+    int cellIndex(int cellX, int cellZ) const { return cellZ * cellsPerSide + cellX; }
+
+    float halfSize;
+    float inverseCellSize;
+    int cellsPerSide;
+    int cellCount;
+
+    std::vector<Body> pending;
+    std::vector<Body> sorted;
+    std::vector<int> cellStart;     // LAYER_COUNT * cellCount + 1 prefix sums into sorted
+    std::vector<int> scatterCursor;
+    int layerCounts[LAYER_COUNT]{};
+    float layerMaxReach[LAYER_COUNT]{};
+};
+
+template<typename F>
+void SpatialHash::forEachPair(CollisionLayer a, CollisionLayer b, F &&onHit) const
+{
+    if (layerCounts[a] == 0 || layerCounts[b] == 0)
+    {
+        return;
+    }
+
+    // Walk the smaller layer and probe the bigger one's cells
+    bool swapped = layerCounts[a] > layerCounts[b];
+    CollisionLayer walk = swapped ? b : a;
+    CollisionLayer probe = swapped ? a : b;
+
+    const int walkBegin = cellStart[walk * cellCount];
+    const int walkEnd = cellStart[(walk + 1) * cellCount];
+    const int *probeCells = &cellStart[probe * cellCount];
+
+    for (int i = walkBegin; i < walkEnd; i++)
+    {
+        const Body &body = sorted[i];
+        float midX = body.x + body.dx * 0.5f;
+        float midZ = body.z + body.dz * 0.5f;
+        float reach = body.reach + layerMaxReach[probe];
+        int minX, minZ, maxX, maxZ;
+        cellOf(midX - reach, midZ - reach, &minX, &minZ);
+        cellOf(midX + reach, midZ + reach, &maxX, &maxZ);
+
+        for (int cellZ = minZ; cellZ <= maxZ; cellZ++)
+        {
+            for (int cellX = minX; cellX <= maxX; cellX++)
+            {
+                int cell = cellIndex(cellX, cellZ);
+                for (int j = probeCells[cell]; j < probeCells[cell + 1]; j++)
+                {
+                    // Move body relative to other, so other sits still at the origin
+                    const Body &other = sorted[j];
+                    Vector3 from = {body.x - other.x, body.y - other.y, body.z - other.z};
+                    Vector3 to = {from.x + body.dx - other.dx, from.y + body.dy - other.dy, from.z + body.dz - other.dz};
+                    float t;
+                    if (sweptSphere(from, to, {0.f, 0.f, 0.f}, body.radius + other.radius, &t))
+                    {
+                        if (swapped)
+                        {
+                            onHit(other.id, body.id, t);
+                        }
+                        else
+                        {
+                            onHit(body.id, other.id, t);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif //GGJ24_SPATIAL_HASH_H
@@ -0,0 +1,112 @@
+#include "sprite_animator.h"
+
+#include <algorithm>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GGJ24_SIMD_X86 1
+#endif
+
+// Columns are padded to this so loads never cross the end, two doubles per SSE2 register
+constexpr int simdWidth{2};
+// Frames shorter than this are played at it, as Aseprite does
+constexpr int minFrameMs{1};
+
+SpriteAnimator::SpriteAnimator(int ticksPerSecond)
+    : ticksPerSecond(ticksPerSecond)
+{
+}
+
+int SpriteAnimator::addClip(const int *durationsMs, int frameCount)
+{
+    // Steps of the largest duration that divides every frame's evenly
+    int stepMs = 0;
+    int loopMs = 0;
+    for (int f = 0; f < frameCount; f++)
+    {
+        int duration = std::max(durationsMs[f], minFrameMs);
+        stepMs = std::gcd(stepMs, duration);
+        loopMs += duration;
+    }
+    Clip clip{static_cast<double>(stepMs) * ticksPerSecond, static_cast<double>(loopMs / stepMs), static_cast<int>(steps.size())};
+    for (int f = 0; f < frameCount; f++)
+    {
+        steps.insert(steps.end(), std::max(durationsMs[f], minFrameMs) / stepMs, f);
+    }
+    clips.push_back(clip);
+    return static_cast<int>(clips.size()) - 1;
+}
+
+int SpriteAnimator::add(int clip)
+{
+    int index = animations++;
+    size_t padded = (animations + simdWidth - 1) / simdWidth * simdWidth;
+    if (start.size() < padded)
+    {
+        start.resize(padded, 0);
+        stepLength.resize(padded, 1.0);
+        loop.resize(padded, 1.0);
+        tableOffset.resize(padded, 0);
+        frame.resize(padded, 0);
+        step.resize(padded, 0);
+    }
+    start[index] = clock;
+    stepLength[index] = clips[clip].stepLength;
+    loop[index] = clips[clip].loop;
+    tableOffset[index] = clips[clip].tableOffset;
+    frame[index] = 0;
+    return index;
+}
+
+void SpriteAnimator::clear()
+{
+    animations = 0;
+    start.clear();
+    stepLength.clear();
+    loop.clear();
+    tableOffset.clear();
+    frame.clear();
+    step.clear();
+}
+
+void SpriteAnimator::evaluate()
+{
+    evaluate(0, animations);
+}
+
+void SpriteAnimator::evaluate(int first, int count)
+{
+    // Elapsed ticks are never negative, so truncating is flooring. Both
+    // divisions are of whole numbers well inside a double's 53 bits, so they
+    // land exactly on a step or a loop when the clock does
+    int i = first;
+    int end = std::min(first + count, animations);
+#ifdef GGJ24_SIMD_X86
+    const __m128i now = _mm_set1_epi32(clock);
+    const __m128d msPerTick = _mm_set1_pd(1000.0);
+    for (; i + simdWidth <= end; i += simdWidth)
+    {
+        __m128i elapsed = _mm_sub_epi32(now, _mm_loadl_epi64(reinterpret_cast<const __m128i *>(start.data() + i)));
+        __m128d time = _mm_mul_pd(_mm_cvtepi32_pd(elapsed), msPerTick);
+        __m128d s = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_div_pd(time, _mm_loadu_pd(stepLength.data() + i))));
+        __m128d length = _mm_loadu_pd(loop.data() + i);
+        __m128d loops = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_div_pd(s, length)));
+        __m128i wrapped = _mm_cvttpd_epi32(_mm_sub_pd(s, _mm_mul_pd(loops, length)));
+        __m128i offset = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(tableOffset.data() + i));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(step.data() + i), _mm_add_epi32(wrapped, offset));
+    }
+#endif
+    // The same sums one at a time, for the odd one out of a SIMD pair
+    for (; i < end; i++)
+    {
+        double s = static_cast<double>(static_cast<int>(static_cast<double>(clock - start[i]) * 1000.0 / stepLength[i]));
+        double loops = static_cast<double>(static_cast<int>(s / loop[i]));
+        step[i] = static_cast<int>(s - loops * loop[i]) + tableOffset[i];
+    }
+    // The table lookup is a gather, SSE2 has none
+    for (i = first; i < end; i++)
+    {
+        frame[i] = steps[step[i]];
+    }
+}
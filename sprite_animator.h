@@ -0,0 +1,71 @@
+/**
+ * Batched sprite animation. Every animation is a row in a set of columns -
+ * its start tick and its clip's step and loop length copied in - and the
+ * frame is worked out from the clock in closed form,
+ *   step = floor((clock - start) / stepLength) mod loop
+ * with no per-animation timers to tick. evaluate() does the whole set in
+ * one SSE2 pass, in doubles that hold every value exactly so a frame never
+ * flips a tick early however long the game runs. Clips with frames of
+ * different lengths step at the largest duration dividing all of them, and
+ * a small table maps steps to frames; for evenly timed clips the table is
+ * the identity and step is the frame.
+*/
+
+#ifndef GGJ24_SPRITE_ANIMATOR_H
+#define GGJ24_SPRITE_ANIMATOR_H
+
+#include <vector>
+
+class SpriteAnimator
+{
+public:
+    // The clock advances 1 / ticksPerSecond per tick()
+    explicit SpriteAnimator(int ticksPerSecond);
+
+    // A looping clip with per-frame durations in ms (such as a sprite's run of
+    // spriteFrameDurations), returns its id
+    int addClip(const int *durationsMs, int frameCount);
+    // Starts an animation of clip on its first frame, returns its index
+    int add(int clip);
+    // Back to the first frame of its clip
+    void restart(int index) { start[index] = clock; }
+    void clear();
+
+    // One sim tick. Not ticking pauses every animation where it is
+    void tick() { clock++; }
+    // Fills frame[] for every animation at the current clock
+    void evaluate();
+    // Just animations [first, first + count), ranges that don't overlap can
+    // be evaluated on different threads
+    void evaluate(int first, int count);
+
+    int count() const { return animations; }
+    // Frame within its clip, as of the last evaluate()
+    int frameOf(int index) const { return frame[index]; }
+
+    // [-------------- COLUMNS -----------------------]
+    // Padded to the SIMD width, only [0, count()) is live
+    std::vector<int> start;             // tick the animation was on its first frame
+    std::vector<double> stepLength;     // one clip step in ms / ticksPerSecond, a whole number
+    std::vector<double> loop;           // steps in one loop of the clip
+    std::vector<int> tableOffset;       // clip's step -> frame table in steps
+    std::vector<int> frame;
+
+private:
+    struct Clip
+    {
+        double stepLength;
+        double loop;
+        int tableOffset;
+    };
+
+    int ticksPerSecond;
+    int clock{0};
+    int animations{0};
+    std::vector<Clip> clips;
+    std::vector<int> steps;
+    // Scratch, step of each animation before the table lookup
+    std::vector<int> step;
+};
+
+#endif //GGJ24_SPRITE_ANIMATOR_H
@@ -0,0 +1,51 @@
+/**
+ * The sprites the game animates and how long each of their frames shows,
+ * everything the sim needs to know about the art. Kept by hand so the sim
+ * (and the headless runner) builds without the art or the atlas packer;
+ * the packed atlas_frames.h checks itself against this at compile time, so
+ * art that stops matching fails the game's build until this is updated.
+ * Frames are numbered across all sprites, sprite s owning frames
+ * spriteFrames[s].first .. first + count - 1.
+*/
+
+#ifndef GGJ24_SPRITE_SHEET_H
+#define GGJ24_SPRITE_SHEET_H
+
+// In the order the packer finds them, sorted by file name
+enum AtlasSprite
+{
+    SPRITE_CAPPY,           // cappy_aseprite.ase
+    SPRITE_CAPPY_CRY,       // cappy_cry.png
+    SPRITE_GRUM,            // clown_ss.aseprite
+    SPRITE_EMPTY_HEART,     // empty_heart.png
+    SPRITE_FULL_HEART,      // full_heart.png
+    SPRITE_COUNT
+};
+
+struct SpriteFrames
+{
+    int first;
+    int count;
+};
+
+constexpr int spriteFrameCount{21};
+
+constexpr SpriteFrames spriteFrames[SPRITE_COUNT] = {
+    {0, 14},    // SPRITE_CAPPY
+    {14, 1},    // SPRITE_CAPPY_CRY
+    {15, 4},    // SPRITE_GRUM
+    {19, 1},    // SPRITE_EMPTY_HEART
+    {20, 1},    // SPRITE_FULL_HEART
+};
+
+// In milliseconds, from the Aseprite files or the packer's :ms - PNGs
+// otherwise show each frame for 100
+constexpr int spriteFrameDurations[spriteFrameCount] = {
+    1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 500, 500, 2000,    // SPRITE_CAPPY
+    100,    // SPRITE_CAPPY_CRY
+    250, 250, 250, 250,    // SPRITE_GRUM
+    100,    // SPRITE_EMPTY_HEART
+    100,    // SPRITE_FULL_HEART
+};
+
+#endif //GGJ24_SPRITE_SHEET_H
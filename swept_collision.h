@@ -0,0 +1,79 @@
+/**
+ * Swept (continuous) collision tests for things that move in straight lines
+ * between ticks. Both return the earliest fraction t of the segment that
+ * touches the shape, so fast projectiles can't tunnel through a target no
+ * matter how low the tick rate is.
+*/
+
+#ifndef GGJ24_SWEPT_COLLISION_H
+#define GGJ24_SWEPT_COLLISION_H
+
+#include "raylib.h"
+
+#include <cmath>
+
+// Segment from -> to against a sphere, strict (touching at exactly radius is a miss)
+inline bool sweptSphere(Vector3 from, Vector3 to, Vector3 centre, float radius, float *t)
+{
+    float mx = from.x - centre.x, my = from.y - centre.y, mz = from.z - centre.z;
+    float dx = to.x - from.x, dy = to.y - from.y, dz = to.z - from.z;
+    float c = mx * mx + my * my + mz * mz - radius * radius;
+    if (c < 0.f)
+    {
+        // Already inside at the start of the move
+        *t = 0.f;
+        return true;
+    }
+
+    float a = dx * dx + dy * dy + dz * dz;
+    float b = mx * dx + my * dy + mz * dz;
+    if (a <= 0.f || b >= 0.f)
+    {
+        // Not moving, or moving away
+        return false;
+    }
+
+    float discriminant = b * b - a * c;
+    if (discriminant <= 0.f)
+    {
+        return false;
+    }
+    float entry = (-b - sqrtf(discriminant)) / a;
+    if (entry > 1.f)
+    {
+        return false;
+    }
+    *t = entry;
+    return true;
+}
+
+// 1 / dir per axis, huge instead of inf for axis-aligned segments so the slab test never sees 0 * inf
+inline Vector3 inverseDirection(Vector3 dir)
+{
+    auto inverse = [](float d) { return fabsf(d) > 1e-12f ? 1.f / d : copysignf(1e30f, d); };
+    return {inverse(dir.x), inverse(dir.y), inverse(dir.z)};
+}
+
+// Segment from + dir * t, t in [0, maxT], against an AABB (slab test). invDir from inverseDirection()
+inline bool sweptAabb(const BoundingBox &box, Vector3 from, Vector3 invDir, float maxT, float *t)
+{
+    float tx1 = (box.min.x - from.x) * invDir.x;
+    float tx2 = (box.max.x - from.x) * invDir.x;
+    float tMin = fminf(tx1, tx2);
+    float tMax = fmaxf(tx1, tx2);
+
+    float ty1 = (box.min.y - from.y) * invDir.y;
+    float ty2 = (box.max.y - from.y) * invDir.y;
+    tMin = fmaxf(tMin, fminf(ty1, ty2));
+    tMax = fminf(tMax, fmaxf(ty1, ty2));
+
+    float tz1 = (box.min.z - from.z) * invDir.z;
+    float tz2 = (box.max.z - from.z) * invDir.z;
+    tMin = fmaxf(tMin, fminf(tz1, tz2));
+    tMax = fminf(tMax, fmaxf(tz1, tz2));
+
+    *t = fmaxf(tMin, 0.f);
+    return tMax >= tMin && tMax >= 0.f && tMin <= maxT;
+}
+
+#endif //GGJ24_SWEPT_COLLISION_H
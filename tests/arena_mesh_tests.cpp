@@ -0,0 +1,97 @@
+#include "arena_mesh.h"
+
+#include "sim_snapshot.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+// Ground quad, four walls and a box per column, six quads of two triangles a box
+constexpr int boxTriangleVertices{6 * 6};
+constexpr int arenaTriangleVertices{6 + 4 * boxTriangleVertices + MAX_COLUMNS * boxTriangleVertices};
+
+static SimSnapshot arenaSnapshot()
+{
+    SimSnapshot snapshot;
+    snapshot.arenaRevision = 0;
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        snapshot.heights[i] = 2.f + i;
+        snapshot.positions[i] = {static_cast<float>(i), snapshot.heights[i] / 2.f, 0.f};
+        snapshot.colors[i] = RED;
+    }
+    return snapshot;
+}
+
+// Highest y in column's outline
+static float outlineTop(const ArenaMesh &mesh, int column)
+{
+    float top = -1.f;
+    for (int v = 0; v < ArenaMesh::boxLineVertices; v++)
+    {
+        top = std::max(top, mesh.lineVertices()[(column * ArenaMesh::boxLineVertices + v) * 3 + 1]);
+    }
+    return top;
+}
+
+TEST_CASE("Baking builds the whole arena", "[arena_mesh]")
+{
+    SimSnapshot snapshot = arenaSnapshot();
+    ArenaMesh mesh;
+    CHECK(mesh.revision() == -1);
+
+    REQUIRE(mesh.bake(snapshot));
+    CHECK(mesh.revision() == 0);
+    CHECK(mesh.triangleVertexCount() == arenaTriangleVertices);
+    CHECK(mesh.triangleColors().size() == mesh.triangleVertices().size() / 3 * 4);
+    CHECK(mesh.lineVertexCount() == MAX_COLUMNS * ArenaMesh::boxLineVertices);
+    CHECK(mesh.lineColors().size() == mesh.lineVertices().size() / 3 * 4);
+    // Outlines run from the ground to the top of each column
+    CHECK(outlineTop(mesh, 0) == Approx(snapshot.heights[0]));
+    CHECK(outlineTop(mesh, MAX_COLUMNS - 1) == Approx(snapshot.heights[MAX_COLUMNS - 1]));
+}
+
+TEST_CASE("Baking again only rebuilds when the arena changed", "[arena_mesh]")
+{
+    SimSnapshot snapshot = arenaSnapshot();
+    ArenaMesh mesh;
+    REQUIRE(mesh.bake(snapshot));
+
+    SECTION("same revision keeps the mesh")
+    {
+        snapshot.heights[3] = 9.f;
+        snapshot.positions[3].y = 4.5f;
+        CHECK_FALSE(mesh.bake(snapshot));
+        CHECK(outlineTop(mesh, 3) == Approx(5.f));
+    }
+    SECTION("a new revision rebuilds it, without growing")
+    {
+        snapshot.heights[3] = 9.f;
+        snapshot.positions[3].y = 4.5f;
+        snapshot.arenaRevision++;
+        CHECK(mesh.bake(snapshot));
+        CHECK(mesh.revision() == 1);
+        CHECK(outlineTop(mesh, 3) == Approx(9.f));
+        CHECK(mesh.triangleVertexCount() == arenaTriangleVertices);
+        CHECK(mesh.lineVertexCount() == MAX_COLUMNS * ArenaMesh::boxLineVertices);
+        CHECK_FALSE(mesh.bake(snapshot));
+    }
+}
+
+TEST_CASE("A sim's arena is baked once per layout", "[arena_mesh]")
+{
+    SimConfig config;
+    config.workers = 0;
+    Sim sim(config);
+    SimSnapshot snapshot;
+    ArenaMesh mesh;
+
+    snapshot.capture(sim);
+    CHECK(mesh.bake(snapshot));
+    for (int i = 0; i < 10; i++)
+    {
+        sim.step({}, sim.tickSeconds());
+        snapshot.capture(sim);
+        CHECK_FALSE(mesh.bake(snapshot));
+    }
+}
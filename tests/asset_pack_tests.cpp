@@ -0,0 +1,179 @@
+#include "asset_pack.h"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Any value will do, the pack only stores it
+constexpr int formatR8G8B8A8{7};
+
+static std::string packPath()
+{
+    return (std::filesystem::temp_directory_path() / "ggj24_asset_pack_tests.pack").string();
+}
+
+static std::vector<unsigned char> pattern(size_t size, unsigned char seed)
+{
+    std::vector<unsigned char> pixels(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        pixels[i] = static_cast<unsigned char>(seed + i * 7);
+    }
+    return pixels;
+}
+
+static std::vector<unsigned char> readFile(const std::string &path)
+{
+    std::vector<unsigned char> bytes(std::filesystem::file_size(path));
+    FILE *file = fopen(path.c_str(), "rb");
+    REQUIRE(file != nullptr);
+    REQUIRE(fread(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    fclose(file);
+    return bytes;
+}
+
+static void writeFile(const std::string &path, const std::vector<unsigned char> &bytes)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    REQUIRE(file != nullptr);
+    REQUIRE(fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    fclose(file);
+}
+
+// Two pages, 16x16 and 8x4, written to packPath()
+static void writeTwoPagePack()
+{
+    std::vector<unsigned char> first = pattern(16 * 16 * 4, 1);
+    std::vector<unsigned char> second = pattern(8 * 4 * 4, 99);
+    AssetPackWriter writer;
+    REQUIRE(writer.add("assets/atlas/atlas_0.png", first.data(), first.size(), 16, 16, formatR8G8B8A8));
+    REQUIRE(writer.add("assets/atlas/atlas_1.png", second.data(), second.size(), 8, 4, formatR8G8B8A8));
+    REQUIRE(writer.write(packPath().c_str()));
+}
+
+// Where entry index's offset field sits in the file
+static size_t offsetField(int index)
+{
+    return sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * index + offsetof(AssetPackEntry, offset);
+}
+
+TEST_CASE("A written pack reads back entry for entry", "[asset_pack]")
+{
+    writeTwoPagePack();
+    AssetPack pack;
+    REQUIRE(pack.open(packPath().c_str()));
+    REQUIRE(pack.entryCount() == 2);
+
+    CHECK(pack.find("assets/atlas/atlas_0.png") == 0);
+    CHECK(pack.find("assets/atlas/atlas_1.png") == 1);
+    CHECK(pack.find("assets/atlas/atlas_2.png") == -1);
+
+    const AssetPackEntry &second = pack.entry(1);
+    CHECK(second.width == 8);
+    CHECK(second.height == 4);
+    CHECK(second.format == formatR8G8B8A8);
+    CHECK(second.mipmaps == 1);
+    REQUIRE(second.size == 8 * 4 * 4);
+    std::vector<unsigned char> expected = pattern(8 * 4 * 4, 99);
+    CHECK(memcmp(pack.pixels(1), expected.data(), expected.size()) == 0);
+    CHECK(second.hash == assetPackHash(expected.data(), expected.size()));
+
+    for (int i = 0; i < pack.entryCount(); i++)
+    {
+        CHECK(pack.entry(i).offset % 64 == 0);
+        CHECK(pack.verify(i));
+    }
+    pack.close();
+    CHECK_FALSE(pack.isOpen());
+}
+
+TEST_CASE("verify catches damaged pixels", "[asset_pack]")
+{
+    writeTwoPagePack();
+    std::vector<unsigned char> bytes = readFile(packPath());
+    uint64_t offset;
+    memcpy(&offset, bytes.data() + offsetField(1), sizeof(offset));
+    bytes[offset + 5] ^= 0xFF;
+    writeFile(packPath(), bytes);
+
+    AssetPack pack;
+    REQUIRE(pack.open(packPath().c_str()));
+    CHECK(pack.verify(0));
+    CHECK_FALSE(pack.verify(1));
+}
+
+TEST_CASE("Broken packs are rejected", "[asset_pack]")
+{
+    writeTwoPagePack();
+    std::vector<unsigned char> bytes = readFile(packPath());
+    AssetPack pack;
+
+    SECTION("missing")
+    {
+        CHECK_FALSE(pack.open((packPath() + ".missing").c_str()));
+    }
+    SECTION("truncated")
+    {
+        bytes.resize(bytes.size() - 16);
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    SECTION("truncated, with the header claiming the shorter size")
+    {
+        // The last blob now runs past the end of the file
+        bytes.resize(bytes.size() - 16);
+        uint64_t fileSize = bytes.size();
+        memcpy(bytes.data() + offsetof(AssetPackHeader, fileSize), &fileSize, sizeof(fileSize));
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    SECTION("cut inside the index")
+    {
+        bytes.resize(sizeof(AssetPackHeader) + sizeof(AssetPackEntry) / 2);
+        uint64_t fileSize = bytes.size();
+        memcpy(bytes.data() + offsetof(AssetPackHeader, fileSize), &fileSize, sizeof(fileSize));
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    SECTION("an offset past the end")
+    {
+        uint64_t offset = bytes.size() + 64;
+        memcpy(bytes.data() + offsetField(0), &offset, sizeof(offset));
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    SECTION("an offset that runs the blob past the end")
+    {
+        uint64_t offset = bytes.size() - 8;
+        memcpy(bytes.data() + offsetField(1), &offset, sizeof(offset));
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    SECTION("another version")
+    {
+        uint32_t version = assetPackVersion + 1;
+        memcpy(bytes.data() + offsetof(AssetPackHeader, version), &version, sizeof(version));
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    SECTION("not a pack")
+    {
+        bytes[0] = 'X';
+        writeFile(packPath(), bytes);
+        CHECK_FALSE(pack.open(packPath().c_str()));
+    }
+    CHECK_FALSE(pack.isOpen());
+}
+
+TEST_CASE("Names too long for the index are refused", "[asset_pack]")
+{
+    unsigned char pixel[4]{};
+    AssetPackWriter writer;
+    CHECK_FALSE(writer.add(std::string(sizeof(AssetPackEntry::name), 'a'), pixel, sizeof(pixel), 1, 1, formatR8G8B8A8));
+    CHECK(writer.add(std::string(sizeof(AssetPackEntry::name) - 1, 'a'), pixel, sizeof(pixel), 1, 1, formatR8G8B8A8));
+}
@@ -0,0 +1,152 @@
+#include "render_list.h"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+static RenderList beginList()
+{
+    RenderList list;
+    list.begin(RAYWHITE, Camera{});
+    return list;
+}
+
+static Texture2D textureWithId(unsigned int id)
+{
+    Texture2D texture{};
+    texture.id = id;
+    return texture;
+}
+
+TEST_CASE("Commands with the same state share one draw call", "[render_list]")
+{
+    RenderList list = beginList();
+    for (int i = 0; i < 10; i++)
+    {
+        list.cube({static_cast<float>(i), 0.f, 0.f}, {1.f, 1.f, 1.f}, RED);
+    }
+    list.sort();
+
+    RenderStats stats = list.stats();
+    CHECK(stats.commands == 10);
+    CHECK(stats.drawCalls == 1);
+    CHECK(stats.vertices == 10 * 36);
+    CHECK(stats.instances == 0);
+}
+
+TEST_CASE("Sorting groups interleaved commands by state", "[render_list]")
+{
+    RenderList list = beginList();
+    for (int i = 0; i < 4; i++)
+    {
+        list.cube({}, {1.f, 1.f, 1.f}, RED);
+        list.cubeWires({}, {1.f, 1.f, 1.f}, BLACK);
+    }
+    list.sort();
+
+    // Triangles then lines, not eight alternating calls
+    RenderStats stats = list.stats();
+    CHECK(stats.drawCalls == 2);
+    CHECK(stats.vertices == 4 * 36 + 4 * 24);
+    CHECK(list.commands().front().primitive == PRIM_CUBE);
+    CHECK(list.commands().back().primitive == PRIM_CUBE_WIRES);
+}
+
+TEST_CASE("State changes split batches", "[render_list]")
+{
+    SECTION("texture")
+    {
+        RenderList list = beginList();
+        list.billboard(textureWithId(1), {0.f, 0.f, 8.f, 8.f}, {}, {1.f, 1.f}, WHITE);
+        list.billboard(textureWithId(2), {0.f, 0.f, 8.f, 8.f}, {}, {1.f, 1.f}, WHITE);
+        list.billboard(textureWithId(1), {0.f, 0.f, 8.f, 8.f}, {}, {1.f, 1.f}, WHITE);
+        list.sort();
+        CHECK(list.stats().drawCalls == 2);
+        CHECK(list.stats().vertices == 3 * 4);
+    }
+    SECTION("blend mode")
+    {
+        RenderList list = beginList();
+        list.cube({}, {1.f, 1.f, 1.f}, RED);
+        list.setBlendMode(BLEND_ADDITIVE);
+        list.cube({}, {1.f, 1.f, 1.f}, RED);
+        list.sort();
+        CHECK(list.stats().drawCalls == 2);
+    }
+    SECTION("pass")
+    {
+        RenderList list = beginList();
+        list.rectangle(0, 0, 10, 10, RED);
+        list.setPass(PASS_SCREEN);
+        list.rectangle(0, 0, 10, 10, RED);
+        list.sort();
+        CHECK(list.stats().drawCalls == 2);
+    }
+    SECTION("layers alone do not")
+    {
+        RenderList list = beginList();
+        list.setPass(PASS_SCREEN, 0);
+        list.rectangle(0, 0, 10, 10, RED);
+        list.setPass(PASS_SCREEN, 1);
+        list.rectangle(0, 0, 10, 10, RED);
+        list.text("ab c", 0, 0, 10, BLACK);
+        list.sort();
+        // Rectangles and text both come from the font atlas as quads
+        CHECK(list.stats().drawCalls == 1);
+        CHECK(list.stats().vertices == 2 * 4 + 3 * 4);
+    }
+}
+
+TEST_CASE("A batch fills at batchVertexLimit", "[render_list]")
+{
+    const int cubesPerBatch = batchVertexLimit / 36;
+
+    RenderList full = beginList();
+    for (int i = 0; i < cubesPerBatch; i++)
+    {
+        full.cube({}, {1.f, 1.f, 1.f}, RED);
+    }
+    full.sort();
+    CHECK(full.stats().drawCalls == 1);
+
+    RenderList over = beginList();
+    for (int i = 0; i < cubesPerBatch + 1; i++)
+    {
+        over.cube({}, {1.f, 1.f, 1.f}, RED);
+    }
+    over.sort();
+    CHECK(over.stats().drawCalls == 2);
+    CHECK(over.stats().vertices == (cubesPerBatch + 1) * 36);
+}
+
+TEST_CASE("Long line lists are submitted a batch at a time", "[render_list]")
+{
+    const int vertexCount = batchVertexLimit * 2 + 2;
+    std::vector<float> vertices(vertexCount * 3);
+    std::vector<unsigned char> colors(vertexCount * 4);
+
+    RenderList list = beginList();
+    list.lines(vertices.data(), colors.data(), vertexCount);
+    list.sort();
+    CHECK(list.stats().drawCalls == 3);
+    CHECK(list.stats().vertices == vertexCount);
+}
+
+TEST_CASE("Mesh draws are one call each outside the batch", "[render_list]")
+{
+    RenderList list = beginList();
+    list.cube({}, {1.f, 1.f, 1.f}, RED);
+    Matrix *transforms = list.meshInstances(MESH_PROJECTILE, 50, GREEN);
+    REQUIRE(transforms != nullptr);
+    list.mesh(MESH_ARENA, 600, WHITE);
+    list.cube({}, {1.f, 1.f, 1.f}, RED);
+    // Empty draws record nothing
+    CHECK(list.meshInstances(MESH_PROJECTILE, 0, GREEN) == nullptr);
+    list.sort();
+
+    RenderStats stats = list.stats();
+    CHECK(stats.commands == 4);
+    CHECK(stats.drawCalls == 3);
+    CHECK(stats.vertices == 2 * 36 + 50 * 24 + 600);
+    CHECK(stats.instances == 50);
+}
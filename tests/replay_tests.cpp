@@ -0,0 +1,137 @@
+#include "replay.h"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static std::string replayPath()
+{
+    return (std::filesystem::temp_directory_path() / "ggj24_replay_tests.rep").string();
+}
+
+static SimConfig replayConfig()
+{
+    SimConfig config;
+    config.seed = 42;
+    config.tickRate = 60;
+    config.crowd = 3;
+    return config;
+}
+
+// A few changes, then a long stretch of standing still
+static std::vector<SimInputs> session(int stillTicks)
+{
+    std::vector<SimInputs> ticks(3);
+    ticks[0].start = true;
+    ticks[1].moveForward = true;
+    ticks[1].mouseDelta = {1.5f, -0.25f};
+    ticks[2].fire = true;
+    ticks.resize(ticks.size() + stillTicks);
+    return ticks;
+}
+
+static void checkSame(const SimInputs &played, const SimInputs &recorded)
+{
+    CHECK(packInputs(played) == packInputs(recorded));
+    CHECK(played.mouseDelta.x == recorded.mouseDelta.x);
+    CHECK(played.mouseDelta.y == recorded.mouseDelta.y);
+}
+
+TEST_CASE("A finished replay plays back every tick", "[replay]")
+{
+    std::vector<SimInputs> ticks = session(500);
+    {
+        ReplayWriter writer;
+        REQUIRE(writer.open(replayPath().c_str(), replayConfig()));
+        for (const SimInputs &inputs : ticks)
+        {
+            writer.record(inputs);
+        }
+        REQUIRE(writer.finish(0x1234));
+    }
+
+    ReplayReader reader;
+    REQUIRE(reader.open(replayPath().c_str()));
+    CHECK(reader.config().seed == 42);
+    CHECK(reader.config().tickRate == 60);
+    CHECK(reader.config().crowd == 3);
+    SimInputs inputs;
+    for (const SimInputs &recorded : ticks)
+    {
+        REQUIRE(reader.next(inputs));
+        checkSame(inputs, recorded);
+    }
+    CHECK_FALSE(reader.next(inputs));
+    CHECK(reader.error()[0] == '\0');
+    REQUIRE(reader.finished());
+    CHECK(reader.recordedTicks() == static_cast<long long>(ticks.size()));
+    CHECK(reader.recordedChecksum() == 0x1234);
+}
+
+TEST_CASE("A session that dies replays up to its last flush", "[replay]")
+{
+    // Three changes then 147 still ticks, the last flush is at tick 120
+    std::vector<SimInputs> ticks = session(147);
+    ReplayWriter writer;
+    REQUIRE(writer.open(replayPath().c_str(), replayConfig()));
+    for (const SimInputs &inputs : ticks)
+    {
+        writer.record(inputs);
+    }
+
+    // Read while the writer is still open, as if the game had died here
+    ReplayReader reader;
+    REQUIRE(reader.open(replayPath().c_str()));
+    SimInputs inputs;
+    long long played = 0;
+    while (reader.next(inputs))
+    {
+        checkSame(inputs, ticks[played]);
+        played++;
+    }
+    CHECK(played == 120);
+    CHECK(reader.error()[0] == '\0');
+    CHECK_FALSE(reader.finished());
+}
+
+TEST_CASE("Headers this build can't play are rejected", "[replay]")
+{
+    {
+        ReplayWriter writer;
+        REQUIRE(writer.open(replayPath().c_str(), replayConfig()));
+        REQUIRE(writer.finish(0));
+    }
+    std::vector<char> bytes(std::filesystem::file_size(replayPath()));
+    FILE *file = fopen(replayPath().c_str(), "rb");
+    REQUIRE(file != nullptr);
+    REQUIRE(fread(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    fclose(file);
+
+    SECTION("tick rate")
+    {
+        int32_t tickRate = 59;
+        memcpy(bytes.data() + offsetof(ReplayHeader, tickRate), &tickRate, sizeof(tickRate));
+    }
+    SECTION("version")
+    {
+        uint32_t version = replayVersion + 1;
+        memcpy(bytes.data() + offsetof(ReplayHeader, version), &version, sizeof(version));
+    }
+    SECTION("magic")
+    {
+        bytes[0] = 'X';
+    }
+    file = fopen(replayPath().c_str(), "wb");
+    REQUIRE(file != nullptr);
+    REQUIRE(fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    fclose(file);
+
+    ReplayReader reader;
+    CHECK_FALSE(reader.open(replayPath().c_str()));
+    CHECK(reader.error()[0] != '\0');
+}
@@ -0,0 +1,82 @@
+#include "scene.h"
+
+#include <catch2/catch.hpp>
+
+#include "raymath.h"
+
+// A snapshot of a fresh match, switched to playing with nothing in flight
+static SimSnapshot playingSnapshot()
+{
+    SimConfig config;
+    config.workers = 0;
+    Sim sim(config);
+    SimSnapshot snapshot;
+    snapshot.capture(sim);
+    snapshot.state = PLAYING;
+    snapshot.previous = snapshot.current;
+    snapshot.pies.clear();
+    snapshot.shots.clear();
+    snapshot.previousPieClock = 0.0;
+    snapshot.pieClock = 0.0;
+    return snapshot;
+}
+
+// A point distance along the camera's view, negative is behind it
+static Vector3 alongView(const SimSnapshot &snapshot, float distance)
+{
+    const Camera &cam = snapshot.current.cam;
+    Vector3 forward = Vector3Normalize(Vector3Subtract(cam.target, cam.position));
+    return Vector3Add(cam.position, Vector3Scale(forward, distance));
+}
+
+static int instancedDraws(const RenderList &list)
+{
+    int draws = 0;
+    for (const RenderCommand &command : list.commands())
+    {
+        draws += command.primitive == PRIM_MESH_INSTANCES ? 1 : 0;
+    }
+    return draws;
+}
+
+TEST_CASE("Pies and shots in view are one instanced draw per type", "[scene]")
+{
+    SimSnapshot snapshot = playingSnapshot();
+    for (int i = 0; i < 20; i++)
+    {
+        snapshot.pies.push_back({alongView(snapshot, 2.f + 0.1f * i), {}, 0.0, 10.0});
+    }
+    // Behind the camera, culled before they reach the list
+    for (int i = 0; i < 5; i++)
+    {
+        snapshot.pies.push_back({alongView(snapshot, -2.f - 0.1f * i), {}, 0.0, 10.0});
+    }
+    for (int i = 0; i < 7; i++)
+    {
+        snapshot.shots.push_back({alongView(snapshot, 3.f + 0.1f * i), {}, 0.f});
+    }
+
+    SceneAssets assets;
+    useStandInAtlas(assets);
+    RenderList list;
+    recordScene(snapshot, 1.f, assets, SceneDebug{}, list);
+    list.sort();
+
+    CHECK(instancedDraws(list) == 2);
+    CHECK(list.stats().instances == 27);
+}
+
+TEST_CASE("Nothing in flight records no instanced draws", "[scene]")
+{
+    SimSnapshot snapshot = playingSnapshot();
+    snapshot.pies.push_back({alongView(snapshot, -3.f), {}, 0.0, 10.0});
+
+    SceneAssets assets;
+    useStandInAtlas(assets);
+    RenderList list;
+    recordScene(snapshot, 1.f, assets, SceneDebug{}, list);
+    list.sort();
+
+    CHECK(instancedDraws(list) == 0);
+    CHECK(list.stats().instances == 0);
+}
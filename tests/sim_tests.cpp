@@ -0,0 +1,31 @@
+#include "sim.h"
+
+#include <catch2/catch.hpp>
+
+// Starts a match and stands still in it for up to a minute, or until it ends
+static void standStill(Sim &sim)
+{
+    SimInputs start;
+    start.start = true;
+    sim.step(start, sim.tickSeconds());
+    REQUIRE(sim.currentGameState == PLAYING);
+    for (int i = 0; i < 60 * sim.tickRate && sim.currentGameState == PLAYING; i++)
+    {
+        sim.step({}, sim.tickSeconds());
+        REQUIRE(sim.currentHealth <= Sim::maxHealth);
+    }
+}
+
+TEST_CASE("Standing still in a crowd loses the match", "[sim]")
+{
+    // A crowd lands several pies on the tick the last heart goes
+    SimConfig config;
+    config.seed = 1;
+    config.crowd = GENERATE(0, 5, 20, 50);
+    config.workers = 0;
+    Sim sim(config);
+
+    standStill(sim);
+    CHECK(sim.currentGameState == GAME_OVER);
+    CHECK(sim.currentHealth == 0);
+}
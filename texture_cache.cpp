@@ -0,0 +1,168 @@
+#include "texture_cache.h"
+
+#include <utility>
+
+// 64-bit FNV-1a, plenty to tell a handful of image files apart
+static uint64_t hashBytes(const unsigned char *data, int size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// [-------------- HANDLE -----------------------]
+
+TextureHandle::TextureHandle(TextureCache *cache, int entry) : cache(cache), entry(entry)
+{
+    cache->retain(entry);
+}
+
+TextureHandle::TextureHandle(const TextureHandle &other) : cache(other.cache), entry(other.entry)
+{
+    if (cache)
+    {
+        cache->retain(entry);
+    }
+}
+
+TextureHandle::TextureHandle(TextureHandle &&other) noexcept
+    : cache(std::exchange(other.cache, nullptr)), entry(std::exchange(other.entry, -1))
+{
+}
+
+TextureHandle &TextureHandle::operator=(TextureHandle other) noexcept
+{
+    std::swap(cache, other.cache);
+    std::swap(entry, other.entry);
+    return *this;
+}
+
+TextureHandle::~TextureHandle()
+{
+    reset();
+}
+
+const Texture2D &TextureHandle::texture() const
+{
+    static const Texture2D none{};
+    return cache ? cache->entries[entry].texture : none;
+}
+
+void TextureHandle::reset()
+{
+    if (cache)
+    {
+        cache->release(entry);
+        cache = nullptr;
+        entry = -1;
+    }
+}
+
+// [-------------- CACHE -----------------------]
+
+TextureCache::~TextureCache()
+{
+    // Handles should be gone by now, don't leak the GPU copies if they aren't
+    for (const auto &[hash, index] : byHash)
+    {
+        UnloadTexture(entries[index].texture);
+    }
+}
+
+TextureHandle TextureCache::load(const char *path)
+{
+    if (auto found = byPath.find(path); found != byPath.end())
+    {
+        return {this, found->second};
+    }
+    DecodedImage decoded;
+    if (!decode(path, decoded))
+    {
+        return {};
+    }
+    return upload(path, decoded);
+}
+
+bool TextureCache::decode(const char *path, DecodedImage &decoded)
+{
+    int size = 0;
+    unsigned char *data = LoadFileData(path, &size);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    decoded.hash = hashBytes(data, size);
+    decoded.image = LoadImageFromMemory(GetFileExtension(path), data, size);
+    UnloadFileData(data);
+    return decoded.image.data != nullptr;
+}
+
+TextureHandle TextureCache::upload(const char *path, DecodedImage &decoded)
+{
+    TextureHandle handle = upload(path, decoded.hash, decoded.image);
+    UnloadImage(decoded.image);
+    decoded.image = {};
+    return handle;
+}
+
+TextureHandle TextureCache::upload(const char *path, uint64_t hash, const Image &image)
+{
+    // Same bytes as something already resident - share it and remember this path too
+    if (auto found = byHash.find(hash); found != byHash.end())
+    {
+        byPath[path] = found->second;
+        return {this, found->second};
+    }
+
+    Texture2D texture = LoadTextureFromImage(image);
+    if (texture.id == 0)
+    {
+        return {};
+    }
+
+    int index;
+    if (freeEntries.empty())
+    {
+        index = static_cast<int>(entries.size());
+        entries.emplace_back();
+    }
+    else
+    {
+        index = freeEntries.back();
+        freeEntries.pop_back();
+    }
+    Entry &entry = entries[index];
+    entry.hash = hash;
+    entry.texture = texture;
+    entry.refs = 0;
+    entry.bytes = static_cast<size_t>(GetPixelDataSize(texture.width, texture.height, texture.format));
+    bytes += entry.bytes;
+    uploads++;
+    byHash[hash] = index;
+    byPath[path] = index;
+    return {this, index};
+}
+
+void TextureCache::retain(int index)
+{
+    entries[index].refs++;
+}
+
+void TextureCache::release(int index)
+{
+    Entry &entry = entries[index];
+    if (--entry.refs > 0)
+    {
+        return;
+    }
+
+    UnloadTexture(entry.texture);
+    bytes -= entry.bytes;
+    byHash.erase(entry.hash);
+    std::erase_if(byPath, [index](const auto &path) { return path.second == index; });
+    entry = {};
+    freeEntries.push_back(index);
+}
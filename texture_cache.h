@@ -0,0 +1,105 @@
+/**
+ * Shared texture cache. Textures are looked up by path and then by a hash of
+ * the file's bytes, so every request for the same image - under any path -
+ * shares one GPU copy. Handles are refcounted and the texture is unloaded
+ * when the last one goes. Needs a GL context, so it lives in the raylib
+ * front end only. Loading is split in two so the CPU half (read, hash,
+ * decode) can run on other threads and only the upload on the GL thread.
+*/
+
+#ifndef GGJ24_TEXTURE_CACHE_H
+#define GGJ24_TEXTURE_CACHE_H
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TextureCache;
+
+// CPU half of a texture load - the file's hash and its decoded pixels
+struct DecodedImage
+{
+    uint64_t hash{0};
+    Image image{};
+};
+
+// One reference to a cached texture. Copies share it, must not outlive the cache
+class TextureHandle
+{
+public:
+    TextureHandle() = default;
+    TextureHandle(const TextureHandle &other);
+    TextureHandle(TextureHandle &&other) noexcept;
+    TextureHandle &operator=(TextureHandle other) noexcept;
+    ~TextureHandle();
+
+    // Empty texture (id 0) for a null handle, like LoadTexture() on a missing file
+    const Texture2D &texture() const;
+    explicit operator bool() const { return cache != nullptr; }
+    // Drops this reference early
+    void reset();
+
+private:
+    friend class TextureCache;
+    TextureHandle(TextureCache *cache, int entry);
+
+    TextureCache *cache{nullptr};
+    int entry{-1};
+};
+
+class TextureCache
+{
+public:
+    TextureCache() = default;
+    TextureCache(const TextureCache &) = delete;
+    TextureCache &operator=(const TextureCache &) = delete;
+    ~TextureCache();
+
+    // Shared handle to the image at path, null if it can't be read or decoded
+    TextureHandle load(const char *path);
+
+    // Reads, hashes and decodes path. Touches no GL or cache state, so it is
+    // safe on any thread. False if the file can't be read or decoded
+    static bool decode(const char *path, DecodedImage &decoded);
+    // GL thread: the cached texture with decoded's hash if there is one,
+    // otherwise uploads it. Frees decoded's pixels either way
+    TextureHandle upload(const char *path, DecodedImage &decoded);
+    // Same, for pixels someone else owns (an asset pack mapping) - uploads
+    // straight from image.data and never frees it
+    TextureHandle upload(const char *path, uint64_t hash, const Image &image);
+
+    // [-------------- STATS -----------------------]
+    int residentCount() const { return static_cast<int>(byHash.size()); }
+    // GPU bytes held by the resident textures, base level only
+    size_t residentBytes() const { return bytes; }
+    // Textures actually decoded and uploaded, as opposed to served from the cache
+    int uploadCount() const { return uploads; }
+
+private:
+    friend class TextureHandle;
+
+    struct Entry
+    {
+        uint64_t hash{0};
+        Texture2D texture{};
+        int refs{0};
+        size_t bytes{0};
+    };
+
+    void retain(int entry);
+    void release(int entry);
+
+    std::vector<Entry> entries;
+    std::vector<int> freeEntries;
+    // Path lookups skip reading the file again, the hash catches the same bytes under another path
+    std::unordered_map<std::string, int> byPath;
+    std::unordered_map<uint64_t, int> byHash;
+    size_t bytes{0};
+    int uploads{0};
+};
+
+#endif //GGJ24_TEXTURE_CACHE_H
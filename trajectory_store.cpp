@@ -0,0 +1,156 @@
+#include "trajectory_store.h"
+
+#include <algorithm>
+
+TrajectoryStore::TrajectoryStore(int capacity)
+{
+    for (auto *column : {&ox, &oy, &oz, &vx, &vy, &vz})
+    {
+        column->assign(capacity, 0.f);
+    }
+    launch.assign(capacity, 0.0);
+    end.assign(capacity, 0.0);
+    idLink.resize(capacity);
+    denseToId.resize(capacity);
+    generation.assign(capacity, 0);
+    checkAt.assign(capacity, -1.0);
+    expiries.reserve(2 * capacity);
+    checks.reserve(2 * capacity);
+    clear();
+}
+
+int TrajectoryStore::spawn(Vector3 origin, Vector3 velocity, double launchTime, double endTime)
+{
+    if (freeHead < 0)
+    {
+        overflows++;
+        return -1;
+    }
+
+    int trajectoryId = freeHead;
+    freeHead = idLink[trajectoryId];
+
+    int index = count++;
+    idLink[trajectoryId] = index;
+    denseToId[index] = trajectoryId;
+    if (count > highWater)
+    {
+        highWater = count;
+    }
+
+    ox[index] = origin.x;
+    oy[index] = origin.y;
+    oz[index] = origin.z;
+    vx[index] = velocity.x;
+    vy[index] = velocity.y;
+    vz[index] = velocity.z;
+    launch[index] = launchTime;
+    end[index] = endTime;
+    pushEvent(expiries, {endTime, trajectoryId, generation[trajectoryId]});
+    return index;
+}
+
+void TrajectoryStore::releaseActive(int index)
+{
+    int trajectoryId = denseToId[index];
+    int last = --count;
+    if (index != last)
+    {
+        ox[index] = ox[last];
+        oy[index] = oy[last];
+        oz[index] = oz[last];
+        vx[index] = vx[last];
+        vy[index] = vy[last];
+        vz[index] = vz[last];
+        launch[index] = launch[last];
+        end[index] = end[last];
+        denseToId[index] = denseToId[last];
+        idLink[denseToId[index]] = index;
+    }
+
+    // Any events still queued for this id are now stale
+    generation[trajectoryId]++;
+    checkAt[trajectoryId] = -1.0;
+    idLink[trajectoryId] = freeHead;
+    freeHead = trajectoryId;
+}
+
+void TrajectoryStore::clear()
+{
+    for (int index = 0; index < count; index++)
+    {
+        generation[denseToId[index]]++;
+    }
+    count = 0;
+    freeHead = -1;
+    for (int trajectoryId = capacity() - 1; trajectoryId >= 0; trajectoryId--)
+    {
+        idLink[trajectoryId] = freeHead;
+        freeHead = trajectoryId;
+        checkAt[trajectoryId] = -1.0;
+    }
+    expiries.clear();
+    checks.clear();
+}
+
+int TrajectoryStore::releaseExpired(double time)
+{
+    int released = 0;
+    while (!expiries.empty() && expiries.front().time <= time)
+    {
+        Event event = expiries.front();
+        std::pop_heap(expiries.begin(), expiries.end(), laterEvent);
+        expiries.pop_back();
+        if (isLive(event))
+        {
+            releaseId(event.trajectoryId);
+            released++;
+        }
+    }
+    return released;
+}
+
+void TrajectoryStore::scheduleCheck(int trajectoryId, double time)
+{
+    checkAt[trajectoryId] = time;
+    pushEvent(checks, {time, trajectoryId, generation[trajectoryId]});
+}
+
+void TrajectoryStore::popDueChecks(double time, std::vector<int> &due)
+{
+    while (!checks.empty() && checks.front().time <= time)
+    {
+        Event event = checks.front();
+        std::pop_heap(checks.begin(), checks.end(), laterEvent);
+        checks.pop_back();
+        // Rescheduled checks leave their old entry behind, only the latest counts
+        if (isLive(event) && checkAt[event.trajectoryId] == event.time)
+        {
+            checkAt[event.trajectoryId] = -1.0;
+            due.push_back(event.trajectoryId);
+        }
+    }
+}
+
+Vector3 TrajectoryStore::position(int index, double time) const
+{
+    float flight = static_cast<float>(std::clamp(time, launch[index], end[index]) - launch[index]);
+    return {ox[index] + vx[index] * flight, oy[index] + vy[index] * flight, oz[index] + vz[index] * flight};
+}
+
+void TrajectoryStore::pushEvent(std::vector<Event> &heap, Event event)
+{
+    // Released and rescheduled trajectories leave stale entries behind - once
+    // they outnumber the live ones, sweep them out instead of growing
+    if (heap.size() >= 2 * idLink.size())
+    {
+        bool checkHeap = &heap == &checks;
+        std::erase_if(heap, [&](const Event &queued)
+        {
+            return !isLive(queued) || (checkHeap && checkAt[queued.trajectoryId] != queued.time);
+        });
+        std::make_heap(heap.begin(), heap.end(), laterEvent);
+    }
+    heap.push_back(event);
+    std::push_heap(heap.begin(), heap.end(), laterEvent);
+}
@@ -0,0 +1,84 @@
+/**
+ * Store for projectiles that fly in a straight line at a constant speed (pies).
+ * Nothing is integrated per tick: each trajectory keeps where and when it was
+ * launched plus the time it ends (lifetime or the wall it will hit), and its
+ * position is evaluated on demand. Expiry and hit checks are events on two
+ * min-heaps keyed by time, so a tick only touches trajectories whose event is
+ * due. Ids and dense packing work the same way as ProjectileStore.
+*/
+
+#ifndef GGJ24_TRAJECTORY_STORE_H
+#define GGJ24_TRAJECTORY_STORE_H
+
+#include "raylib.h"
+
+#include <vector>
+
+class TrajectoryStore
+{
+public:
+    explicit TrajectoryStore(int capacity);
+
+    // Returns the dense index of the new trajectory, or -1 (and counts an overflow)
+    // when full. releaseExpired() drops it once the clock reaches endTime
+    int spawn(Vector3 origin, Vector3 velocity, double launchTime, double endTime);
+    // Release by dense index - the last trajectory is swapped into index
+    void releaseActive(int index);
+    void releaseId(int trajectoryId) { releaseActive(idLink[trajectoryId]); }
+    void clear();
+
+    // Releases everything whose endTime <= time, returns how many went
+    int releaseExpired(double time);
+
+    // [-------------- HIT CHECK SCHEDULE -----------------------]
+    // One pending check per trajectory, scheduling again replaces the old one
+    void scheduleCheck(int trajectoryId, double time);
+    // Appends the ids of every check due by time to due and unschedules them
+    void popDueChecks(double time, std::vector<int> &due);
+
+    int activeCount() const { return count; }
+    int id(int index) const { return denseToId[index]; }
+    int indexOf(int trajectoryId) const { return idLink[trajectoryId]; }
+    Vector3 velocity(int index) const { return {vx[index], vy[index], vz[index]}; }
+    double launchTime(int index) const { return launch[index]; }
+    double endTime(int index) const { return end[index]; }
+    // Where the trajectory is at time, clamped to its launch and end
+    Vector3 position(int index, double time) const;
+
+    // [-------------- SIZING COUNTERS -----------------------]
+    int capacity() const { return static_cast<int>(idLink.size()); }
+    int highWaterMark() const { return highWater; }
+    long long overflowCount() const { return overflows; }
+
+    // [-------------- COLUMNS -----------------------]
+    // Only [0, activeCount()) is live
+    std::vector<float> ox, oy, oz;
+    std::vector<float> vx, vy, vz;
+    std::vector<double> launch, end;
+
+private:
+    struct Event
+    {
+        double time;
+        int trajectoryId;
+        unsigned int generation;    // of the id when pushed, stale once it is released
+    };
+
+    // Min-heap order on time for std::push_heap / std::pop_heap
+    static bool laterEvent(const Event &a, const Event &b) { return a.time > b.time; }
+    void pushEvent(std::vector<Event> &heap, Event event);
+    bool isLive(const Event &event) const { return generation[event.trajectoryId] == event.generation; }
+
+    std::vector<int> idLink;    // next free id while free, dense index while live
+    std::vector<int> denseToId;
+    std::vector<unsigned int> generation;
+    std::vector<double> checkAt;    // pending check per id, negative when none
+    std::vector<Event> expiries;
+    std::vector<Event> checks;
+    int count{0};
+    int freeHead{-1};
+    int highWater{0};
+    long long overflows{0};
+};
+
+#endif //GGJ24_TRAJECTORY_STORE_H
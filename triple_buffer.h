@@ -0,0 +1,52 @@
+/**
+ * Lock-free triple buffer for handing a value from one writer thread to one
+ * reader thread. The writer fills back() and publish()es it, the reader
+ * picks up the newest published value with front(); neither ever waits on
+ * the other. Three slots so each side always owns one, with the third
+ * parked between them - the newest published one, or the one the reader
+ * last let go of. Values a reader is too slow to see are simply skipped.
+*/
+
+#ifndef GGJ24_TRIPLE_BUFFER_H
+#define GGJ24_TRIPLE_BUFFER_H
+
+#include <atomic>
+
+template<typename T>
+class TripleBuffer
+{
+public:
+    // [-------------- WRITER -----------------------]
+    // The writer's own slot, whatever it last held until it is refilled. Kept
+    // between publishes so the slots' storage gets reused
+    T &back() { return slots[backIndex]; }
+    // Parks back() as the newest value and takes the parked slot in its place
+    void publish()
+    {
+        backIndex = parked.exchange(backIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // [-------------- READER -----------------------]
+    // The newest published value, or the one front() returned last time if
+    // nothing was published since. Stays unchanged until the next front()
+    const T &front()
+    {
+        if ((parked.load(std::memory_order_relaxed) & freshBit) != 0)
+        {
+            frontIndex = parked.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+        }
+        return slots[frontIndex];
+    }
+
+private:
+    static constexpr int indexMask{3};
+    static constexpr int freshBit{4};
+
+    T slots[3];
+    int backIndex{0};
+    int frontIndex{1};
+    // Index of the parked slot, plus freshBit while the reader has not taken it
+    std::atomic<int> parked{2};
+};
+
+#endif //GGJ24_TRIPLE_BUFFER_H